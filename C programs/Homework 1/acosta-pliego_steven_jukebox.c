@@ -15,10 +15,13 @@
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#include <emscripten/eventloop.h> // emscripten_set_timeout paces the lyrics
 #endif
 
 #define MAX_SONGS 5
 #define MAX_LINE 256
+#define LYRIC_LINE_MS 120          // Gap before a lyric line without a timestamp
+#define PENDING_INPUT_MAX 4096     // Input held back while a song plays
 
 typedef struct {
     char artist[50];
@@ -38,6 +41,31 @@ static Song songs[MAX_SONGS] = {
 
 static int jukebox_active = 1;
 
+// Lyric playback. A song is read whole and split into lines, each due some time after playback
+// starts: a line that begins with an LRC timestamp such as [01:23.45] at that time, any other
+// line LYRIC_LINE_MS after the one before. Nothing blocks: in the browser a timer prints
+// whatever is due and re-arms itself for the next line, so the module needs no ASYNCIFY.
+// Input that arrives during a song runs once it ends, as it did when playback blocked.
+typedef struct {
+    int offset;     // Into lyric_text
+    int length;
+    double due_ms;  // After playback starts
+} LyricLine;
+
+static char *lyric_text = NULL;
+static LyricLine *lyric_lines = NULL;
+static int lyric_count = 0;
+static int lyric_next = 0;      // First line not printed yet
+static int lyrics_playing = 0;
+#ifdef __EMSCRIPTEN__
+static double lyric_start_ms = 0.0;
+static long lyric_timer = 0;
+#endif
+static char pending_input[PENDING_INPUT_MAX]; // Newline-separated
+static int pending_length = 0;
+
+void process_jukebox_input(const char* input_str);
+
 // Renamed to avoid conflict if original main is used for local testing
 void printMenu_internal() {
     printf("\n%-3s%-32s%-32s%-30s\n", " ", "Artist", "Song", "Album");
@@ -50,39 +78,186 @@ void printMenu_internal() {
     fflush(stdout);
 }
 
-// Renamed to avoid conflict
-void displayLyrics_internal(const char *fileName) {
+// Reads a leading [mm:ss] or [mm:ss.xx] timestamp. Returns its length, or 0 if there is none.
+static int parse_lyric_time(const char *line, int length, double *ms) {
+    int i = 1, minutes = 0, seconds = 0, digits = 0;
+    if (length < 1 || line[0] != '[') return 0;
+    for (; i < length && line[i] >= '0' && line[i] <= '9' && digits < 3; i++, digits++) {
+        minutes = minutes * 10 + (line[i] - '0');
+    }
+    if (digits == 0 || i >= length || line[i++] != ':') return 0;
+    for (digits = 0; i < length && line[i] >= '0' && line[i] <= '9' && digits < 2; i++, digits++) {
+        seconds = seconds * 10 + (line[i] - '0');
+    }
+    if (digits == 0) return 0;
+    double fraction = 0.0, place = 0.1;
+    if (i < length && line[i] == '.') {
+        for (i++; i < length && line[i] >= '0' && line[i] <= '9'; i++, place /= 10) {
+            fraction += (line[i] - '0') * place;
+        }
+    }
+    if (i >= length || line[i] != ']') return 0;
+    *ms = (minutes * 60 + seconds + fraction) * 1000.0;
+    return i + 1;
+}
+
+// LRC header tags such as [ar:Artist] hold no lyrics
+static int is_lyric_tag(const char *line, int length) {
+    int i = 1;
+    if (length < 3 || line[0] != '[' || line[length - 1] != ']') return 0;
+    while (i < length && ((line[i] >= 'a' && line[i] <= 'z') || (line[i] >= 'A' && line[i] <= 'Z'))) i++;
+    return i > 1 && i < length && line[i] == ':';
+}
+
+static void lyrics_clear() {
+    free(lyric_text);
+    free(lyric_lines);
+    lyric_text = NULL;
+    lyric_lines = NULL;
+    lyric_count = lyric_next = 0;
+    lyrics_playing = 0;
+}
+
+// Reads the song and times its lines. On error the song simply has no lines.
+static void lyrics_load(const char *fileName) {
     int fd = open(fileName, O_RDONLY);
     if (fd == -1) {
         printf("Error opening file: %s\n", fileName); // perror might not be ideal for web output
         fflush(stdout);
         return;
     }
-
-    char buffer[MAX_LINE];
-    ssize_t bytesRead;
-    while ((bytesRead = read(fd, buffer, sizeof(buffer) - 1)) > 0) {
-        buffer[bytesRead] = '\0';
-        printf("%s", buffer);
-        fflush(stdout);
-        #ifdef __EMSCRIPTEN__
-        emscripten_sleep(100); // Reduced sleep time for better web UX, adjust as needed
-        #else
-        // sleep(1); // For local testing
-        #endif
+    size_t capacity = 4 * MAX_LINE, used = 0;
+    char *text = (char *)malloc(capacity);
+    ssize_t bytesRead = 0;
+    while (text != NULL && (bytesRead = read(fd, text + used, capacity - used)) > 0) {
+        used += (size_t)bytesRead;
+        if (used == capacity) {
+            char *grown = (char *)realloc(text, capacity * 2);
+            if (grown == NULL) {
+                free(text);
+                text = NULL;
+                break;
+            }
+            text = grown;
+            capacity *= 2;
+        }
     }
-
-    if (bytesRead == -1) {
+    close(fd);
+    if (text == NULL || bytesRead == -1) {
         printf("Error reading file: %s\n", fileName);
         fflush(stdout);
+        free(text);
+        return;
+    }
+
+    int lines = 1;
+    for (size_t i = 0; i < used; i++) lines += text[i] == '\n';
+    lyric_lines = (LyricLine *)malloc(lines * sizeof(LyricLine));
+    if (lyric_lines == NULL) {
+        free(text);
+        return;
+    }
+    lyric_text = text;
+    double due = -LYRIC_LINE_MS; // The first untimed line plays at once
+    for (size_t start = 0; start < used;) {
+        const char *newline = memchr(text + start, '\n', used - start);
+        size_t end = newline ? (size_t)(newline - text) : used;
+        int length = (int)(end - start);
+        if (length > 0 && text[end - 1] == '\r') length--;
+        const char *line = text + start;
+        double stamp;
+        int skip = parse_lyric_time(line, length, &stamp);
+        if (skip > 0) {
+            due = stamp > due ? stamp : due; // Out-of-order stamps play straight after the line before
+        } else {
+            due += LYRIC_LINE_MS;
+        }
+        if (skip > 0 || !is_lyric_tag(line, length)) {
+            lyric_lines[lyric_count].offset = (int)start + skip;
+            lyric_lines[lyric_count].length = length - skip;
+            lyric_lines[lyric_count].due_ms = due;
+            lyric_count++;
+        }
+        start = end + 1;
+    }
+}
+
+// Runs the input that arrived while the song played, until one of the commands starts another song
+static void run_pending_input() {
+    char line[MAX_LINE];
+    while (!lyrics_playing && pending_length > 0) {
+        const char *newline = memchr(pending_input, '\n', (size_t)pending_length);
+        int n = (int)(newline - pending_input);
+        int copy = n < MAX_LINE - 1 ? n : MAX_LINE - 1;
+        memcpy(line, pending_input, copy);
+        line[copy] = '\0';
+        pending_length -= n + 1;
+        memmove(pending_input, pending_input + n + 1, (size_t)pending_length);
+        process_jukebox_input(line);
     }
-    close(fd);
+}
+
+// Prints every line due `elapsed_ms` into the song and returns how long until the next one,
+// or -1 once the song is over and the menu is back
+static double lyrics_tick(double elapsed_ms) {
+    while (lyric_next < lyric_count && lyric_lines[lyric_next].due_ms <= elapsed_ms) {
+        const LyricLine *line = &lyric_lines[lyric_next++];
+        printf("%.*s\n", line->length, lyric_text + line->offset);
+    }
+    fflush(stdout);
+    if (lyric_next < lyric_count) {
+        return lyric_lines[lyric_next].due_ms - elapsed_ms;
+    }
+    lyrics_clear();
+    printf("\n\n"); // Extra newlines after lyrics
+    fflush(stdout);
+    if (jukebox_active) {
+        printMenu_internal(); // Show menu again for next choice
+    }
+    run_pending_input();
+    return -1;
+}
+
+#ifdef __EMSCRIPTEN__
+static void lyrics_timer_fired(void *unused) {
+    (void)unused;
+    double delay = lyrics_tick(emscripten_get_now() - lyric_start_ms);
+    if (delay >= 0) {
+        lyric_timer = emscripten_set_timeout(lyrics_timer_fired, delay, NULL);
+    }
+}
+#endif
+
+// Stops the song and drops any input waiting for it
+static void lyrics_stop() {
+#ifdef __EMSCRIPTEN__
+    if (lyrics_playing) emscripten_clear_timeout(lyric_timer);
+#endif
+    lyrics_clear();
+    pending_length = 0;
+}
+
+// Renamed to avoid conflict
+// Starts the song and returns; the lines follow on their own schedule
+void displayLyrics_internal(const char *fileName) {
+    lyrics_load(fileName);
+    lyrics_playing = 1;
+#ifdef __EMSCRIPTEN__
+    lyric_start_ms = emscripten_get_now();
+    lyrics_timer_fired(NULL);
+#else
+    // No event loop to wait on natively: jump straight to each line's time
+    while (lyrics_playing) {
+        lyrics_tick(lyric_next < lyric_count ? lyric_lines[lyric_next].due_ms : 0.0);
+    }
+#endif
 }
 
 #ifdef __EMSCRIPTEN__
 EMSCRIPTEN_KEEPALIVE
 #endif
 void init_jukebox() {
+    lyrics_stop();
     jukebox_active = 1;
     printf("Welcome to Steven's Lyric Jukebox!\nPlease select a track from the list below:\n\n");
     fflush(stdout);
@@ -98,6 +273,18 @@ void process_jukebox_input(const char* input_str) {
         fflush(stdout);
         return;
     }
+    if (lyrics_playing) { // Waits for the song to finish
+        int n = (int)strcspn(input_str, "\n");
+        if (n > MAX_LINE - 1 || pending_length + n + 1 > PENDING_INPUT_MAX) {
+            printf("Still playing; input ignored.\n");
+            fflush(stdout);
+            return;
+        }
+        memcpy(pending_input + pending_length, input_str, (size_t)n);
+        pending_input[pending_length + n] = '\n';
+        pending_length += n + 1;
+        return;
+    }
 
     int choice = atoi(input_str);
 
@@ -109,12 +296,7 @@ void process_jukebox_input(const char* input_str) {
     } else if (choice >= 1 && choice <= MAX_SONGS) {
         printf("\nPlaying: %s - %s - %s\n\n", songs[choice - 1].artist, songs[choice - 1].songName, songs[choice - 1].album);
         fflush(stdout);
-        displayLyrics_internal(songs[choice - 1].fileName);
-        printf("\n\n"); // Extra newlines after lyrics
-        fflush(stdout);
-        if (jukebox_active) { // If not exited during lyrics (not possible with current setup)
-            printMenu_internal(); // Show menu again for next choice
-        }
+        displayLyrics_internal(songs[choice - 1].fileName); // Prints the menu again when the song ends
     } else {
         printf("Invalid choice. Please select a valid track number.\n");
         fflush(stdout);
@@ -124,6 +306,36 @@ void process_jukebox_input(const char* input_str) {
     }
 }
 
+// Feeds each non-empty line of a script to process_jukebox_input. Commands after a song
+// choice wait for that song to finish playing. A line of MAX_LINE characters or more stops
+// the script rather than being cut short.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void process_jukebox_batch(const char* lines, int len) {
+    char line[MAX_LINE];
+    int line_number = 0;
+    const char* end = lines + len;
+    for (const char* p = lines; p < end;) {
+        const char* newline = memchr(p, '\n', (size_t)(end - p));
+        if (!newline) newline = end;
+        size_t n = (size_t)(newline - p);
+        if (n > 0 && p[n - 1] == '\r') n--;
+        line_number++;
+        if (n > sizeof(line) - 1) {
+            printf("Script stopped: line %d is too long.\n", line_number);
+            fflush(stdout);
+            break;
+        }
+        if (n > 0) {
+            memcpy(line, p, n);
+            line[n] = '\0';
+            process_jukebox_input(line);
+        }
+        p = newline + 1;
+    }
+}
+
 // --- Main function for local command-line testing ---
 #ifndef __EMSCRIPTEN__
 int main() {
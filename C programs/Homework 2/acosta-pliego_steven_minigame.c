@@ -150,6 +150,35 @@ void process_minigame_guess(const char* input_str) {
     fflush(stdout);
 }
 
+// Plays a list of guesses, one per line; blank lines are skipped. A line too long for the
+// buffer ends the list with an error instead of being cut short.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void process_minigame_batch(const char* lines, int len) {
+    char line[256];
+    int line_number = 0;
+    const char* end = lines + len;
+    for (const char* p = lines; p < end;) {
+        const char* newline = memchr(p, '\n', (size_t)(end - p));
+        if (!newline) newline = end;
+        size_t n = (size_t)(newline - p);
+        if (n > 0 && p[n - 1] == '\r') n--;
+        line_number++;
+        if (n > sizeof(line) - 1) {
+            printf("Guess list stopped: line %d is too long.\n", line_number);
+            fflush(stdout);
+            break;
+        }
+        if (n > 0) {
+            memcpy(line, p, n);
+            line[n] = '\0';
+            process_minigame_guess(line);
+        }
+        p = newline + 1;
+    }
+}
+
 // Keep main for local testing if desired, but it won't be called by Emscripten in this setup
 #ifndef __EMSCRIPTEN__
 int main() {
@@ -5,9 +5,64 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h> // For isdigit
+#include <time.h>  // For clock_gettime in benchmarks
+#include <stddef.h> // For offsetof
+#include <stdint.h>
+#include <math.h>  // For HUGE_VAL
 
 #ifdef __EMSCRIPTEN__
 #include <emscripten.h>
+#else
+#include <fcntl.h>    // For open() when mapping snapshots
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>  // Sessions served from several threads
+#include <stdatomic.h>
+#include "../common/check_output.h" // Quiet stdout and result lines for the check modes
+#endif
+
+// SIMD kernels for the columnar reports: wasm SIMD128 (-msimd128), SSE2/AVX natively,
+// scalar otherwise. Define INVENTORY_NO_SIMD to force the scalar path.
+#if defined(INVENTORY_NO_SIMD)
+#define INVENTORY_SIMD_NAME "scalar"
+#elif defined(__wasm_simd128__)
+#include <wasm_simd128.h>
+#define INVENTORY_SIMD_NAME "wasm simd128"
+#define INVENTORY_SIMD_LANES 4
+#elif defined(__SSE2__)
+#include <immintrin.h>
+#ifdef __AVX__
+#define INVENTORY_SIMD_NAME "avx"
+#else
+#define INVENTORY_SIMD_NAME "sse2"
+#endif
+#define INVENTORY_SIMD_LANES 4
+#else
+#define INVENTORY_SIMD_NAME "scalar"
+#endif
+
+// Store synchronization. Natively, operator sessions on different threads share the store
+// through a readers-writer lock: lookups, reports and scans run side by side, mutations alone.
+// The browser build is single-threaded, so the locks compile away. Bulk import, snapshots,
+// journal/checkpoint/recovery calls and shutdown are administrative: run them while no
+// sessions are active.
+#ifdef __EMSCRIPTEN__
+#define INVENTORY_THREAD_LOCAL
+#define STORE_READ_LOCK()
+#define STORE_WRITE_LOCK()
+#define STORE_UNLOCK()
+#define TRIE_LOCK()
+#define TRIE_UNLOCK()
+#else
+#define INVENTORY_THREAD_LOCAL _Thread_local
+static pthread_rwlock_t store_lock = PTHREAD_RWLOCK_INITIALIZER;
+static pthread_mutex_t trie_lock = PTHREAD_MUTEX_INITIALIZER; // Readers may build the trie lazily
+#define STORE_READ_LOCK() pthread_rwlock_rdlock(&store_lock)
+#define STORE_WRITE_LOCK() pthread_rwlock_wrlock(&store_lock)
+#define STORE_UNLOCK() pthread_rwlock_unlock(&store_lock)
+#define TRIE_LOCK() pthread_mutex_lock(&trie_lock)
+#define TRIE_UNLOCK() pthread_mutex_unlock(&trie_lock)
 #endif
 
 // Define the Product structure
@@ -24,16 +79,162 @@ typedef struct {
     } details;
 } Product;
 
-// Node structure for linked list
+// Snapshots store Product records verbatim, so its layout must not drift between builds
+_Static_assert(sizeof(Product) == 164, "Product layout changed; bump SNAPSHOT_VERSION");
+
+// Node structure for linked list. Product fields live in the columnar store at column_row.
 typedef struct Node {
-    Product product;
     struct Node* next;
+    struct Node* prev;           // Back link so a node found through the index unlinks in O(1)
+    struct Node* same_name_next; // Older product sharing this name (index keeps the newest)
+    int column_row;              // Row of this product in the columnar store
+    int low_stock_slot;          // Position in low_stock_nodes, -1 when not below the reorder threshold
 } Node;
 
 Node* head = NULL; // Global pointer for the linked list
 
+// --- Node Pool ---
+// Nodes are carved out of slabs instead of one malloc each. Deleted nodes go on a
+// free-list for reuse, and clearing the inventory releases whole slabs without walking the list.
+#define NODE_SLAB_CAPACITY 1024 // Default slab size; bulk imports reserve one larger slab
+
+typedef struct NodeSlab {
+    struct NodeSlab* next_slab;
+    int capacity;
+    Node nodes[];
+} NodeSlab;
+
+static NodeSlab* node_slabs = NULL;       // Most recently allocated slab first
+static int node_slab_next_free = 0;       // Bump index into node_slabs
+static Node* node_free_list = NULL;       // Recycled nodes, linked through `next`
+static size_t node_pool_live = 0;         // Nodes handed out and not yet freed
+static size_t node_pool_slab_count = 0;
+static size_t node_pool_bytes_reserved = 0;
+
+// --- Name Index ---
+// Open-addressing (linear probing) hash table from Product.name to its newest Node.
+// Lookups used to walk the whole list with strcmp; this keeps them O(1) on average.
+typedef struct {
+    unsigned int hash;
+    Node* node; // NULL: empty slot, NAME_INDEX_TOMBSTONE: deleted slot
+} NameIndexSlot;
+
+static char name_index_tombstone_marker;
+#define NAME_INDEX_TOMBSTONE ((Node*)&name_index_tombstone_marker)
+#define NAME_INDEX_MIN_CAPACITY 64
+
+static NameIndexSlot* name_index_slots = NULL;
+static unsigned int name_index_capacity = 0;  // Always a power of two
+static unsigned int name_index_used = 0;      // Live entries
+static unsigned int name_index_tombstones = 0;
+
+// --- Columnar Store ---
+// Struct-of-arrays product records: the only copy of product data. Nodes carry just their
+// links and row, so reports stream through a few contiguous arrays and a product costs a few
+// dozen fixed bytes instead of a ~200-byte Node. Names and descriptions live in one string
+// arena; descriptions are interned, so repeated text is stored once.
+// Rows are swap-removed on delete; row_node maps a row back to its Node.
+typedef struct {
+    int count;
+    int capacity;
+    int* quantity;
+    float* price;
+    int* length;   // Dimension columns hold 0 for products with a description
+    int* width;
+    int* height;
+    unsigned int* name_offset; // Offset of the product name in `strings`
+    unsigned int* description; // Interned description id, 0 for products with dimensions
+    Node** row_node;
+    char* strings;             // NUL-terminated names and interned descriptions
+    size_t strings_used;
+    size_t strings_capacity;
+    size_t strings_garbage;    // Bytes of deleted names and unreferenced descriptions
+} ColumnStore;
+
+static ColumnStore columns;
+#define COLUMN_ROW_BYTES (5 * sizeof(int) + 2 * sizeof(unsigned int) + sizeof(Node*))
+
+// Interned descriptions, addressed by id (index + 1) and found through an open-addressing
+// set of ids. Entries whose count drops to zero stay findable until the next compaction.
+typedef struct {
+    unsigned int offset; // Offset of the text in columns.strings
+    unsigned int hash;
+    unsigned int refs;   // Rows using this description
+} InternEntry;
+
+static InternEntry* intern_entries = NULL;
+static unsigned int intern_count = 0;
+static unsigned int intern_capacity = 0;
+static unsigned int* intern_slots = NULL;  // Entry ids, 0 for empty
+static unsigned int intern_slot_capacity = 0; // Always a power of two
+
+// Record accessors: product fields by node
+static inline const char* node_name(const Node* node) {
+    return columns.strings + columns.name_offset[node->column_row];
+}
+
+static inline int node_quantity(const Node* node) {
+    return columns.quantity[node->column_row];
+}
+
+static inline float node_price(const Node* node) {
+    return columns.price[node->column_row];
+}
+
+// --- Ordered Indexes ---
+// Skip lists over price and quantity, ordered by (key, Node address), so range queries and
+// sorted listings cost O(log n + k). Skip nodes come from an arena with per-height free-lists.
+#define SKIP_MAX_LEVEL 20
+#define SKIP_ARENA_CHUNK (64 * 1024)
+
+typedef struct SkipNode {
+    double key;
+    Node* node;
+    int level;
+    struct SkipNode* forward[]; // `level` pointers
+} SkipNode;
+
+typedef struct {
+    SkipNode* header; // Sentinel with SKIP_MAX_LEVEL forward pointers
+    int level;
+    int count;
+} SkipList;
+
+typedef struct SkipArenaChunk {
+    struct SkipArenaChunk* next_chunk;
+    size_t used;
+    unsigned char data[SKIP_ARENA_CHUNK];
+} SkipArenaChunk;
+
+static SkipList price_index;
+static SkipList quantity_index;
+static SkipArenaChunk* skip_chunks = NULL;
+static SkipNode* skip_free_lists[SKIP_MAX_LEVEL + 1]; // Freed skip nodes by height, linked via forward[0]
+static unsigned int skip_seed = 0x9E3779B9u;
+static int ordered_index_deferred = 0; // Bulk imports skip per-row inserts and rebuild once at the end
+
+// --- Name Trie ---
+// Character trie over product names for prefix autocomplete and edit-distance suggestions.
+// Nodes live in one growable array and link by index; children are kept sorted by character.
+// `live` counts products below a node, so subtrees emptied by deletes are skipped without
+// being freed. The trie is built lazily on the first query and maintained incrementally after.
+typedef struct {
+    int first_child;  // -1 for none
+    int next_sibling; // -1 for none
+    int live;         // Products whose name passes through this node
+    int terminal;     // Products whose name ends here
+    unsigned char ch;
+} TrieNode;
+
+#define SUGGEST_MAX_RESULTS 32
+
+static TrieNode* trie_nodes = NULL; // trie_nodes[0] is the root
+static int trie_count = 0;
+static int trie_capacity = 0;
+static int name_trie_built = 0;
+static INVENTORY_THREAD_LOCAL char suggestion_buffer[SUGGEST_MAX_RESULTS * 51 + 1];
+
 // --- State Management for Emscripten Interface ---
-static int inventory_active = 1; // 1 if active, 0 if user exited
 
 // Operations
 #define OP_MAIN_MENU 0
@@ -41,365 +242,3669 @@ static int inventory_active = 1; // 1 if active, 0 if user exited
 #define OP_UPDATE_QUANTITY 2
 #define OP_UPDATE_PRICE 3
 #define OP_DELETE_PRODUCT 4
+#define OP_LOW_STOCK_SCAN 5
+#define OP_RANGE_QUERY 6
+#define OP_SORTED_DISPLAY 7
+#define OP_SET_THRESHOLD 8
+
+// Ordered index fields for range queries and sorted display
+#define FIELD_QUANTITY 1
+#define FIELD_PRICE 2
+
+// Everything one operator's menu conversation needs between inputs. The browser drives the
+// default session; the native build can serve any number of them against the shared store.
+typedef struct {
+    int active;            // 1 if active, 0 if user exited
+    int operation;
+    int step;
+    Product product;       // Buffer for adding/updating products
+    char name[50];         // Buffer for name lookups (update/delete)
+    Node* target;          // Product found in step 0 of an update, reused in step 1
+    unsigned long target_generation; // store_generation when `target` was looked up
+    int query_field;       // Field chosen in step 0 of a range query
+    double query_min;      // Lower bound from step 1 of a range query
+} InventorySession;
 
-static int current_operation = OP_MAIN_MENU;
-static int current_step = 0;
-static Product temp_product_buffer; // Buffer for adding/updating products
-static char name_buffer[50];       // Buffer for name lookups (update/delete)
+static InventorySession default_session = {.active = 1, .operation = OP_MAIN_MENU, .query_field = FIELD_QUANTITY};
+
+// Session whose input is being handled on this thread
+static INVENTORY_THREAD_LOCAL InventorySession* session = &default_session;
+// Sessions from inventory_session_create still open. Changed under the write lock.
+static int created_sessions = 0;
+// Bumped whenever a node may have been freed, so a cached session target can be revalidated
+static unsigned long store_generation = 0;
+// Set while process_inventory_batch runs on this thread: menus and flushes wait for its end
+static INVENTORY_THREAD_LOCAL int batch_running = 0;
+
+// Flushes interactive output, except inside a batch, which flushes once when it finishes
+static void flush_output() {
+    if (!batch_running) {
+        fflush(stdout);
+    }
+}
 
 // --- Helper Functions ---
 
-void print_main_menu() {
-    printf("\nInventory Management System\n");
-    printf("1. Add product\n");
-    printf("2. Display products\n");
-    printf("3. Update product quantity\n");
-    printf("4. Update product price\n");
-    printf("5. Delete product\n");
-    printf("6. Exit\n");
-    printf("Enter your choice:\n");
-    fflush(stdout);
+// FNV-1a over the NUL-terminated name
+unsigned int hash_name(const char* name) {
+    unsigned int h = 2166136261u;
+    while (*name) {
+        h ^= (unsigned char)*name++;
+        h *= 16777619u;
+    }
+    return h;
 }
 
-void reset_to_main_menu() {
-    current_operation = OP_MAIN_MENU;
-    current_step = 0;
-    if (inventory_active) {
-        print_main_menu();
+// Returns the slot holding `name`, or the slot where it should be inserted
+static NameIndexSlot* name_index_probe(const char* name, unsigned int hash) {
+    unsigned int mask = name_index_capacity - 1;
+    unsigned int i = hash & mask;
+    NameIndexSlot* first_tombstone = NULL;
+    while (1) {
+        NameIndexSlot* slot = &name_index_slots[i];
+        if (slot->node == NULL) {
+            return first_tombstone ? first_tombstone : slot;
+        }
+        if (slot->node == NAME_INDEX_TOMBSTONE) {
+            if (!first_tombstone) first_tombstone = slot;
+        } else if (slot->hash == hash && strcmp(node_name(slot->node), name) == 0) {
+            return slot;
+        }
+        i = (i + 1) & mask;
     }
 }
 
-// --- Core Logic Functions (modified or new) ---
+static int name_index_resize(unsigned int new_capacity) {
+    NameIndexSlot* old_slots = name_index_slots;
+    unsigned int old_capacity = name_index_capacity;
+    NameIndexSlot* new_slots = (NameIndexSlot*)calloc(new_capacity, sizeof(NameIndexSlot));
+    if (!new_slots) {
+        return 0;
+    }
+    name_index_slots = new_slots;
+    name_index_capacity = new_capacity;
+    name_index_tombstones = 0;
+    for (unsigned int i = 0; i < old_capacity; i++) {
+        Node* node = old_slots[i].node;
+        if (node && node != NAME_INDEX_TOMBSTONE) {
+            unsigned int j = old_slots[i].hash & (new_capacity - 1);
+            while (new_slots[j].node) {
+                j = (j + 1) & (new_capacity - 1);
+            }
+            new_slots[j] = old_slots[i];
+        }
+    }
+    free(old_slots);
+    return 1;
+}
 
-void displayProducts_internal() { // Renamed to avoid conflict if we export original
-    if (!head) {
-        printf("Cannot display any products. Inventory is empty.\n");
-        fflush(stdout);
+Node* name_index_find(const char* name) {
+    if (name_index_used == 0) {
+        return NULL;
+    }
+    NameIndexSlot* slot = name_index_probe(name, hash_name(name));
+    return (slot->node && slot->node != NAME_INDEX_TOMBSTONE) ? slot->node : NULL;
+}
+
+int name_index_insert(Node* node) {
+    // Keep (live + tombstones) under 70% so probe chains stay short
+    if ((name_index_used + name_index_tombstones + 1) * 10 >= name_index_capacity * 7) {
+        unsigned int new_capacity = name_index_capacity ? name_index_capacity : NAME_INDEX_MIN_CAPACITY;
+        while ((name_index_used + 1) * 10 >= new_capacity * 5) {
+            new_capacity *= 2;
+        }
+        if (!name_index_resize(new_capacity)) {
+            return 0;
+        }
+    }
+    unsigned int hash = hash_name(node_name(node));
+    NameIndexSlot* slot = name_index_probe(node_name(node), hash);
+    if (slot->node && slot->node != NAME_INDEX_TOMBSTONE) {
+        // Duplicate name: the newest product wins lookups, same as the old head-first walk
+        node->same_name_next = slot->node;
+        slot->node = node;
+        return 1;
+    }
+    if (slot->node == NAME_INDEX_TOMBSTONE) {
+        name_index_tombstones--;
+    }
+    node->same_name_next = NULL;
+    slot->hash = hash;
+    slot->node = node;
+    name_index_used++;
+    return 1;
+}
+
+// Grows the table up front so `count` more inserts will not trigger a rehash
+int name_index_reserve(unsigned int count) {
+    unsigned int new_capacity = name_index_capacity ? name_index_capacity : NAME_INDEX_MIN_CAPACITY;
+    while ((name_index_used + count) * 10 >= new_capacity * 5) {
+        new_capacity *= 2;
+    }
+    return new_capacity == name_index_capacity || name_index_resize(new_capacity);
+}
+
+void name_index_remove(Node* node) {
+    if (name_index_used == 0) {
+        return;
+    }
+    NameIndexSlot* slot = name_index_probe(node_name(node), hash_name(node_name(node)));
+    if (!slot->node || slot->node == NAME_INDEX_TOMBSTONE) {
         return;
     }
-    Node* temp = head;
-    printf("\n--- Current Inventory ---\n");
-    printf("Name                Quantity    Price       Details\n");
-    printf("----------------------------------------------------------\n");
-    while (temp) {
-        printf("%-20s%-12d%-10.2f", temp->product.name, temp->product.quantity, temp->product.price);
-        if (temp->product.hasDimensions) {
-            printf("%dx%dx%d\n",
-                   temp->product.details.dimensions.length,
-                   temp->product.details.dimensions.width,
-                   temp->product.details.dimensions.height);
+    if (slot->node == node) {
+        if (node->same_name_next) {
+            slot->node = node->same_name_next;
         } else {
-            printf("%s\n", temp->product.details.description);
+            slot->node = NAME_INDEX_TOMBSTONE;
+            name_index_used--;
+            name_index_tombstones++;
+        }
+    } else {
+        // An older duplicate: unlink it from the same-name chain
+        Node* dup = slot->node;
+        while (dup->same_name_next && dup->same_name_next != node) {
+            dup = dup->same_name_next;
+        }
+        if (dup->same_name_next == node) {
+            dup->same_name_next = node->same_name_next;
         }
-        temp = temp->next;
     }
-    printf("----------------------------------------------------------\n");
-    fflush(stdout);
+    node->same_name_next = NULL;
 }
 
-void finalize_add_product() {
-    Node* newNode = (Node*)malloc(sizeof(Node));
-    if (!newNode) {
-        printf("Memory allocation failed for new product.\n");
-        fflush(stdout);
-        return;
+void name_index_clear() {
+    free(name_index_slots);
+    name_index_slots = NULL;
+    name_index_capacity = 0;
+    name_index_used = 0;
+    name_index_tombstones = 0;
+}
+
+static int node_pool_add_slab(int capacity) {
+    size_t bytes = sizeof(NodeSlab) + (size_t)capacity * sizeof(Node);
+    NodeSlab* slab = (NodeSlab*)malloc(bytes);
+    if (!slab) {
+        return 0;
     }
-    newNode->product = temp_product_buffer; // Copy from buffer
-    newNode->next = head;
-    head = newNode;
-    printf("Product '%s' added successfully!\n", temp_product_buffer.name);
-    fflush(stdout);
+    slab->next_slab = node_slabs;
+    slab->capacity = capacity;
+    node_slabs = slab;
+    node_slab_next_free = 0;
+    node_pool_slab_count++;
+    node_pool_bytes_reserved += bytes;
+    return 1;
 }
 
-void handle_add_product_step(const char* input) {
-    switch (current_step) {
-        case 0: // Expecting product name
-            strncpy(temp_product_buffer.name, input, 49);
-            temp_product_buffer.name[49] = '\0';
-            current_step++;
-            printf("Enter quantity for '%s': \n", temp_product_buffer.name);
-            break;
-        case 1: // Expecting quantity
-            temp_product_buffer.quantity = atoi(input);
-            current_step++;
-            printf("Enter price for '%s': \n", temp_product_buffer.name);
-            break;
-        case 2: // Expecting price
-            temp_product_buffer.price = atof(input);
-            current_step++;
-            printf("Does '%s' have dimensions (0 - No, 1 - Yes): \n", temp_product_buffer.name);
-            break;
-        case 3: // Expecting hasDimensions
-            temp_product_buffer.hasDimensions = atoi(input);
-            if (temp_product_buffer.hasDimensions != 0 && temp_product_buffer.hasDimensions != 1) {
-                 printf("Invalid choice for dimensions. Assuming No (0).\n");
-                 temp_product_buffer.hasDimensions = 0;
-            }
-            if (temp_product_buffer.hasDimensions) {
-                current_step++; // Move to step 4 for length
-                printf("Enter length for '%s': \n", temp_product_buffer.name);
-            } else {
-                current_step = 7; // Skip to step 7 for description
-                printf("Enter product description for '%s': \n", temp_product_buffer.name);
-            }
-            break;
-        case 4: // Expecting length
-            temp_product_buffer.details.dimensions.length = atoi(input);
-            current_step++;
-            printf("Enter width for '%s': \n", temp_product_buffer.name);
-            break;
-        case 5: // Expecting width
-            temp_product_buffer.details.dimensions.width = atoi(input);
-            current_step++;
-            printf("Enter height for '%s': \n", temp_product_buffer.name);
-            break;
-        case 6: // Expecting height
-            temp_product_buffer.details.dimensions.height = atoi(input);
-            finalize_add_product();
-            reset_to_main_menu();
-            break;
-        case 7: // Expecting description
-            strncpy(temp_product_buffer.details.description, input, 99);
-            temp_product_buffer.details.description[99] = '\0';
-            finalize_add_product();
-            reset_to_main_menu();
-            break;
+Node* node_pool_alloc() {
+    Node* node;
+    if (node_free_list) {
+        node = node_free_list;
+        node_free_list = node->next;
+    } else {
+        if ((!node_slabs || node_slab_next_free == node_slabs->capacity) && !node_pool_add_slab(NODE_SLAB_CAPACITY)) {
+            return NULL;
+        }
+        node = &node_slabs->nodes[node_slab_next_free++];
     }
-    fflush(stdout);
+    node_pool_live++;
+    return node;
 }
 
-void handle_update_quantity_step(const char* input) {
-    Node* temp = head;
-    switch (current_step) {
-        case 0: // Expecting product name
-            strncpy(name_buffer, input, 49);
-            name_buffer[49] = '\0';
-            while (temp) {
-                if (strcmp(temp->product.name, name_buffer) == 0) {
-                    current_step++;
-                    printf("Enter new quantity for '%s' (current: %d): ", name_buffer, temp->product.quantity);
-                    fflush(stdout);
-                    return;
-                }
-                temp = temp->next;
-            }
-            printf("Product '%s' not found.\n", name_buffer);
-            fflush(stdout);
-            reset_to_main_menu();
-            break;
-        case 1: // Expecting new quantity
-            temp = head; // Re-find the product (or pass it via a static pointer)
-            while (temp) {
-                if (strcmp(temp->product.name, name_buffer) == 0) {
-                    temp->product.quantity = atoi(input);
-                    printf("Quantity for '%s' updated to %d.\n", name_buffer, temp->product.quantity);
-                    fflush(stdout);
-                    reset_to_main_menu();
-                    return;
-                }
-                temp = temp->next;
-            }
-            // Should not happen if name was found in step 0
-            printf("Error: Product '%s' lost during update.\n", name_buffer);
-            fflush(stdout);
-            reset_to_main_menu();
-            break;
+// Makes sure the next `count` allocations come from one contiguous slab.
+// Any unused tail of the previous slab stays idle until the next clear.
+int node_pool_reserve(int count) {
+    int remaining = node_slabs ? node_slabs->capacity - node_slab_next_free : 0;
+    if (remaining >= count) {
+        return 1;
     }
+    return node_pool_add_slab(count > NODE_SLAB_CAPACITY ? count : NODE_SLAB_CAPACITY);
 }
 
-void handle_update_price_step(const char* input) {
-    Node* temp = head;
-     switch (current_step) {
-        case 0: // Expecting product name
-            strncpy(name_buffer, input, 49);
-            name_buffer[49] = '\0';
-            while (temp) {
-                if (strcmp(temp->product.name, name_buffer) == 0) {
-                    current_step++;
-                    printf("Enter new price for '%s' (current: %.2f): ", name_buffer, temp->product.price);
-                    fflush(stdout);
-                    return;
-                }
-                temp = temp->next;
-            }
-            printf("Product '%s' not found.\n", name_buffer);
-            fflush(stdout);
-            reset_to_main_menu();
-            break;
-        case 1: // Expecting new price
-            temp = head;
-            while (temp) {
-                if (strcmp(temp->product.name, name_buffer) == 0) {
-                    temp->product.price = atof(input);
-                    printf("Price for '%s' updated to %.2f.\n", name_buffer, temp->product.price);
-                    fflush(stdout);
-                    reset_to_main_menu();
-                    return;
-                }
-                temp = temp->next;
-            }
-            printf("Error: Product '%s' lost during update.\n", name_buffer);
-            fflush(stdout);
-            reset_to_main_menu();
-            break;
+// Hands out `count` consecutive nodes from one slab, for bulk loads
+Node* node_pool_alloc_block(int count) {
+    if (!node_pool_reserve(count)) {
+        return NULL;
     }
+    Node* block = &node_slabs->nodes[node_slab_next_free];
+    node_slab_next_free += count;
+    node_pool_live += count;
+    return block;
 }
 
-void handle_delete_product_step(const char* input_name) {
-    Node *temp = head, *prev = NULL;
-    int found = 0;
-    while (temp) {
-        if (strcmp(temp->product.name, input_name) == 0) {
-            if (prev)
-                prev->next = temp->next;
-            else
-                head = temp->next;
-            free(temp);
-            printf("Product '%s' deleted successfully!\n", input_name);
-            found = 1;
-            break;
-        }
-        prev = temp;
-        temp = temp->next;
+void node_pool_free(Node* node) {
+    node->next = node_free_list;
+    node_free_list = node;
+    node_pool_live--;
+}
+
+// Frees every slab in one pass; all nodes handed out become invalid
+void node_pool_release_all() {
+    while (node_slabs) {
+        NodeSlab* slab = node_slabs;
+        node_slabs = slab->next_slab;
+        free(slab);
     }
-    if (!found) {
-        printf("Product '%s' not found for deletion.\n", input_name);
+    node_slab_next_free = 0;
+    node_free_list = NULL;
+    node_pool_live = 0;
+    node_pool_slab_count = 0;
+    node_pool_bytes_reserved = 0;
+}
+
+void print_memory_usage() {
+    printf("\n--- Memory Usage ---\n");
+    printf("Live products:   %zu\n", node_pool_live);
+    printf("Slabs:           %zu\n", node_pool_slab_count);
+    printf("Node bytes:      %zu reserved, %zu in use\n", node_pool_bytes_reserved, node_pool_live * sizeof(Node));
+    printf("Index bytes:     %zu (%u slots)\n", (size_t)name_index_capacity * sizeof(NameIndexSlot), name_index_capacity);
+    printf("Column bytes:    %zu (%d rows reserved)\n", (size_t)columns.capacity * COLUMN_ROW_BYTES, columns.capacity);
+    printf("String arena:    %zu bytes, %zu garbage, %u interned descriptions\n",
+           columns.strings_used, columns.strings_garbage, intern_count);
+    flush_output();
+}
+
+// --- Columnar Store Maintenance ---
+
+static int column_grow(int min_capacity) {
+    int capacity = columns.capacity ? columns.capacity : 1024;
+    while (capacity < min_capacity) {
+        capacity *= 2;
     }
-    fflush(stdout);
-    reset_to_main_menu(); // Always reset after attempting deletion
+    int* quantity = (int*)realloc(columns.quantity, capacity * sizeof(int));
+    if (quantity) columns.quantity = quantity;
+    float* price = (float*)realloc(columns.price, capacity * sizeof(float));
+    if (price) columns.price = price;
+    int* length = (int*)realloc(columns.length, capacity * sizeof(int));
+    if (length) columns.length = length;
+    int* width = (int*)realloc(columns.width, capacity * sizeof(int));
+    if (width) columns.width = width;
+    int* height = (int*)realloc(columns.height, capacity * sizeof(int));
+    if (height) columns.height = height;
+    unsigned int* name_offset = (unsigned int*)realloc(columns.name_offset, capacity * sizeof(unsigned int));
+    if (name_offset) columns.name_offset = name_offset;
+    unsigned int* description = (unsigned int*)realloc(columns.description, capacity * sizeof(unsigned int));
+    if (description) columns.description = description;
+    Node** row_node = (Node**)realloc(columns.row_node, capacity * sizeof(Node*));
+    if (row_node) columns.row_node = row_node;
+    if (!quantity || !price || !length || !width || !height || !name_offset || !description || !row_node) {
+        return 0; // Arrays that did grow are kept; capacity stays at the old size
+    }
+    columns.capacity = capacity;
+    return 1;
 }
 
+// Appends `len` bytes to the string arena and returns their offset, or -1 on allocation failure
+static long strings_append(const char* text, size_t len) {
+    if (columns.strings_used + len > columns.strings_capacity) {
+        size_t capacity = columns.strings_capacity ? columns.strings_capacity : 16384;
+        while (columns.strings_used + len > capacity) {
+            capacity *= 2;
+        }
+        char* strings = (char*)realloc(columns.strings, capacity);
+        if (!strings) {
+            return -1;
+        }
+        columns.strings = strings;
+        columns.strings_capacity = capacity;
+    }
+    size_t offset = columns.strings_used;
+    memcpy(columns.strings + offset, text, len);
+    columns.strings_used += len;
+    return (long)offset;
+}
 
-// --- Emscripten Interface Functions ---
-#ifdef __EMSCRIPTEN__
-EMSCRIPTEN_KEEPALIVE
-#endif
-void init_inventory() {
-    // Free any existing list if re-initializing (e.g. component re-mount)
-    while (head) {
-        Node* temp = head;
-        head = head->next;
-        free(temp);
+static int intern_rehash(unsigned int slot_capacity) {
+    unsigned int* slots = (unsigned int*)calloc(slot_capacity, sizeof(unsigned int));
+    if (!slots) {
+        return 0;
+    }
+    for (unsigned int id = 1; id <= intern_count; id++) {
+        unsigned int i = intern_entries[id - 1].hash & (slot_capacity - 1);
+        while (slots[i]) i = (i + 1) & (slot_capacity - 1);
+        slots[i] = id;
     }
-    head = NULL; // Ensure head is NULL
+    free(intern_slots);
+    intern_slots = slots;
+    intern_slot_capacity = slot_capacity;
+    return 1;
+}
 
-    inventory_active = 1;
-    current_operation = OP_MAIN_MENU;
-    current_step = 0;
-    print_main_menu();
+// Id of `text` in the intern table, adding it if new, with one more reference. 0 on failure.
+static unsigned int intern_description(const char* text) {
+    size_t len = strlen(text) + 1;
+    unsigned int hash = hash_name(text);
+    if ((intern_count + 1) * 2 > intern_slot_capacity &&
+        !intern_rehash(intern_slot_capacity ? intern_slot_capacity * 2 : 256)) {
+        return 0;
+    }
+    unsigned int i = hash & (intern_slot_capacity - 1);
+    for (; intern_slots[i]; i = (i + 1) & (intern_slot_capacity - 1)) {
+        InternEntry* entry = &intern_entries[intern_slots[i] - 1];
+        if (entry->hash == hash && strcmp(columns.strings + entry->offset, text) == 0) {
+            if (entry->refs++ == 0) {
+                columns.strings_garbage -= len; // Revived before compaction dropped it
+            }
+            return intern_slots[i];
+        }
+    }
+    if (intern_count == intern_capacity) {
+        unsigned int capacity = intern_capacity ? intern_capacity * 2 : 256;
+        InternEntry* entries = (InternEntry*)realloc(intern_entries, capacity * sizeof(InternEntry));
+        if (!entries) {
+            return 0;
+        }
+        intern_entries = entries;
+        intern_capacity = capacity;
+    }
+    long offset = strings_append(text, len);
+    if (offset < 0) {
+        return 0;
+    }
+    intern_entries[intern_count] = (InternEntry){(unsigned int)offset, hash, 1};
+    intern_slots[i] = ++intern_count;
+    return intern_count;
 }
 
-#ifdef __EMSCRIPTEN__
-EMSCRIPTEN_KEEPALIVE
-#endif
-void process_inventory_input(const char* input_str) {
-    fflush(stdout);
+static void intern_release(unsigned int id) {
+    InternEntry* entry = &intern_entries[id - 1];
+    if (--entry->refs == 0) {
+        columns.strings_garbage += strlen(columns.strings + entry->offset) + 1;
+    }
+}
 
-    if (!inventory_active) {
-        printf("Inventory session has ended. Please re-initialize to start a new session.\n");
-        fflush(stdout);
+// Rewrites the string arena with only live names and referenced descriptions, dropping
+// unreferenced intern entries and renumbering the rest
+static void column_compact_strings() {
+    char* strings = (char*)malloc(columns.strings_used - columns.strings_garbage + 1);
+    unsigned int* new_ids = (unsigned int*)malloc((intern_count + 1) * sizeof(unsigned int));
+    if (!strings || !new_ids) {
+        free(strings);
+        free(new_ids);
         return;
     }
-
-    if (current_operation == OP_MAIN_MENU) {
-        int choice = atoi(input_str);
-        switch (choice) {
-            case 1: // Add product
-                current_operation = OP_ADD_PRODUCT;
-                current_step = 0;
-                printf("Enter product name: \n");
-                fflush(stdout);
-                break;
-            case 2: // Display products
-                displayProducts_internal();
-                reset_to_main_menu(); // Stay in main menu, just re-prompt
-                break;
-            case 3: // Update product quantity
-                current_operation = OP_UPDATE_QUANTITY;
-                current_step = 0;
-                printf("Enter product name to update quantity: \n");
-                fflush(stdout);
-                break;
-            case 4: // Update product price
-                current_operation = OP_UPDATE_PRICE;
-                current_step = 0;
-                printf("Enter product name to update price: \n");
-                fflush(stdout);
-                break;
-            case 5: // Delete product
-                current_operation = OP_DELETE_PRODUCT;
-                current_step = 0; // Step 0 will ask for name
-                printf("Enter product name to delete: \n");
-                fflush(stdout);
-                break;
-            case 6: // Exit
-                printf("Exiting program. Freeing memory...\n");
-                fflush(stdout);
-                while (head) {
-                    Node* temp_node = head;
-                    head = head->next;
-                    free(temp_node);
-                }
-                printf("All products freed. Session ended.\n");
-                inventory_active = 0;
-                fflush(stdout);
-                break;
-            default:
-                printf("Invalid choice. Please try again.\n");
-                fflush(stdout);
-                reset_to_main_menu(); // Re-prompt main menu
-                break;
+    size_t used = 0;
+    unsigned int live = 0;
+    new_ids[0] = 0;
+    for (unsigned int id = 1; id <= intern_count; id++) {
+        InternEntry entry = intern_entries[id - 1];
+        new_ids[id] = 0;
+        if (entry.refs > 0) {
+            size_t len = strlen(columns.strings + entry.offset) + 1;
+            memcpy(strings + used, columns.strings + entry.offset, len);
+            entry.offset = (unsigned int)used;
+            intern_entries[live++] = entry;
+            new_ids[id] = live;
+            used += len;
         }
-    } else if (current_operation == OP_ADD_PRODUCT) {
-        handle_add_product_step(input_str);
-    } else if (current_operation == OP_UPDATE_QUANTITY) {
-        handle_update_quantity_step(input_str);
-    } else if (current_operation == OP_UPDATE_PRICE) {
-        handle_update_price_step(input_str);
-    } else if (current_operation == OP_DELETE_PRODUCT) {
-        // For delete, we get the name directly, no further steps needed from user after this input
-        handle_delete_product_step(input_str);
     }
+    for (int row = 0; row < columns.count; row++) {
+        size_t len = strlen(columns.strings + columns.name_offset[row]) + 1;
+        memcpy(strings + used, columns.strings + columns.name_offset[row], len);
+        columns.name_offset[row] = (unsigned int)used;
+        columns.description[row] = new_ids[columns.description[row]];
+        used += len;
+    }
+    free(new_ids);
+    free(columns.strings);
+    columns.strings = strings;
+    columns.strings_capacity = columns.strings_used - columns.strings_garbage + 1;
+    columns.strings_used = used;
+    columns.strings_garbage = 0;
+    intern_count = live;
+    intern_rehash(intern_slot_capacity); // Same capacity, so this only fails if calloc does
 }
 
-// --- Main function for local command-line testing ---
-#ifndef __EMSCRIPTEN__
-// Original functions that used scanf, for reference or local testing setup
-Product original_createProduct_scanf() {
-    Product p;
-    printf("Enter product name: "); scanf(" %[^\n]", p.name);
-    printf("Enter quantity: "); scanf("%d", &p.quantity);
-    printf("Enter price: "); scanf("%f", &p.price);
-    printf("Does this product have dimensions (0 - No, 1 - Yes): "); scanf("%d", &p.hasDimensions);
-    if (p.hasDimensions) {
-        printf("Enter length, width, and height: ");
-        scanf("%d %d %d", &p.details.dimensions.length, &p.details.dimensions.width, &p.details.dimensions.height);
+// Adds a row holding `product` for `node`
+int column_append(Node* node, const Product* product) {
+    if (columns.count == columns.capacity && !column_grow(columns.count + 1)) {
+        return 0;
+    }
+    unsigned int description = 0;
+    if (!product->hasDimensions && !(description = intern_description(product->details.description))) {
+        return 0;
+    }
+    long name_offset = strings_append(product->name, strnlen(product->name, sizeof(product->name) - 1) + 1);
+    if (name_offset < 0) {
+        if (description) intern_release(description);
+        return 0;
+    }
+    columns.strings[columns.strings_used - 1] = '\0';
+    int row = columns.count++;
+    columns.name_offset[row] = (unsigned int)name_offset;
+    columns.description[row] = description;
+    columns.quantity[row] = product->quantity;
+    columns.price[row] = product->price;
+    if (product->hasDimensions) {
+        columns.length[row] = product->details.dimensions.length;
+        columns.width[row] = product->details.dimensions.width;
+        columns.height[row] = product->details.dimensions.height;
     } else {
-        printf("Enter product description: "); scanf(" %[^\n]", p.details.description);
+        columns.length[row] = columns.width[row] = columns.height[row] = 0;
     }
-    return p;
+    columns.row_node[row] = node;
+    node->column_row = row;
+    return 1;
 }
 
-int main() {
-    init_inventory(); // Start with the menu
+// Swap-removes the node's row; the last row moves into its place
+void column_remove(Node* node) {
+    int row = node->column_row;
+    int last = --columns.count;
+    columns.strings_garbage += strlen(columns.strings + columns.name_offset[row]) + 1;
+    if (columns.description[row]) {
+        intern_release(columns.description[row]);
+    }
+    if (row != last) {
+        columns.quantity[row] = columns.quantity[last];
+        columns.price[row] = columns.price[last];
+        columns.length[row] = columns.length[last];
+        columns.width[row] = columns.width[last];
+        columns.height[row] = columns.height[last];
+        columns.name_offset[row] = columns.name_offset[last];
+        columns.description[row] = columns.description[last];
+        columns.row_node[row] = columns.row_node[last];
+        columns.row_node[row]->column_row = row;
+    }
+    if (columns.strings_garbage > 65536 && columns.strings_garbage * 2 > columns.strings_used) {
+        column_compact_strings();
+    }
+}
 
-    char buffer[100];
-    while (inventory_active) {
-        // The prompt is already printed by init_inventory or reset_to_main_menu or step handlers
-        if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
-            buffer[strcspn(buffer, "\n")] = 0; // Remove newline
-            if (strlen(buffer) == 0 && current_operation != OP_MAIN_MENU) {
+void column_clear() {
+    free(columns.quantity);
+    free(columns.price);
+    free(columns.length);
+    free(columns.width);
+    free(columns.height);
+    free(columns.name_offset);
+    free(columns.description);
+    free(columns.row_node);
+    free(columns.strings);
+    memset(&columns, 0, sizeof(columns));
+    free(intern_entries);
+    free(intern_slots);
+    intern_entries = NULL;
+    intern_slots = NULL;
+    intern_count = intern_capacity = intern_slot_capacity = 0;
+}
+
+// Expands a row back into a full Product, for the journal, snapshots and API callers
+void column_read_product(int row, Product* out) {
+    memset(out, 0, sizeof(*out));
+    strcpy(out->name, columns.strings + columns.name_offset[row]);
+    out->quantity = columns.quantity[row];
+    out->price = columns.price[row];
+    out->hasDimensions = columns.description[row] == 0;
+    if (out->hasDimensions) {
+        out->details.dimensions.length = columns.length[row];
+        out->details.dimensions.width = columns.width[row];
+        out->details.dimensions.height = columns.height[row];
+    } else {
+        const char* text = columns.strings + intern_entries[columns.description[row] - 1].offset;
+        strncpy(out->details.description, text, sizeof(out->details.description) - 1);
+    }
+}
+
+// --- Vectorized Column Kernels ---
+// Products are widened to double before multiplying so the totals match a scalar list walk.
+
+#ifdef INVENTORY_SIMD_LANES
+#if defined(__wasm_simd128__)
+typedef struct { v128_t lo, hi; } vd4; // Four doubles as two f64x2 halves
+
+static inline vd4 vd4_zero() { vd4 r = {wasm_f64x2_splat(0.0), wasm_f64x2_splat(0.0)}; return r; }
+static inline vd4 vd4_load_i32(const int* p) {
+    v128_t v = wasm_v128_load(p);
+    vd4 r = {wasm_f64x2_convert_low_i32x4(v), wasm_f64x2_convert_low_i32x4(wasm_i32x4_shuffle(v, v, 2, 3, 0, 1))};
+    return r;
+}
+static inline vd4 vd4_load_f32(const float* p) {
+    v128_t v = wasm_v128_load(p);
+    vd4 r = {wasm_f64x2_promote_low_f32x4(v), wasm_f64x2_promote_low_f32x4(wasm_i32x4_shuffle(v, v, 2, 3, 0, 1))};
+    return r;
+}
+static inline vd4 vd4_mul(vd4 a, vd4 b) { vd4 r = {wasm_f64x2_mul(a.lo, b.lo), wasm_f64x2_mul(a.hi, b.hi)}; return r; }
+static inline vd4 vd4_add(vd4 a, vd4 b) { vd4 r = {wasm_f64x2_add(a.lo, b.lo), wasm_f64x2_add(a.hi, b.hi)}; return r; }
+static inline double vd4_sum(vd4 a) {
+    v128_t s = wasm_f64x2_add(a.lo, a.hi);
+    return wasm_f64x2_extract_lane(s, 0) + wasm_f64x2_extract_lane(s, 1);
+}
+// Bit i set when p[i] < threshold
+static inline int vi4_less_mask(const int* p, int threshold) {
+    return wasm_i32x4_bitmask(wasm_i32x4_lt(wasm_v128_load(p), wasm_i32x4_splat(threshold)));
+}
+#elif defined(__AVX__)
+typedef __m256d vd4;
+
+static inline vd4 vd4_zero() { return _mm256_setzero_pd(); }
+static inline vd4 vd4_load_i32(const int* p) { return _mm256_cvtepi32_pd(_mm_loadu_si128((const __m128i*)p)); }
+static inline vd4 vd4_load_f32(const float* p) { return _mm256_cvtps_pd(_mm_loadu_ps(p)); }
+static inline vd4 vd4_mul(vd4 a, vd4 b) { return _mm256_mul_pd(a, b); }
+static inline vd4 vd4_add(vd4 a, vd4 b) { return _mm256_add_pd(a, b); }
+static inline double vd4_sum(vd4 a) {
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+static inline int vi4_less_mask(const int* p, int threshold) {
+    __m128i lt = _mm_cmplt_epi32(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi32(threshold));
+    return _mm_movemask_ps(_mm_castsi128_ps(lt));
+}
+#else // SSE2
+typedef struct { __m128d lo, hi; } vd4;
+
+static inline vd4 vd4_zero() { vd4 r = {_mm_setzero_pd(), _mm_setzero_pd()}; return r; }
+static inline vd4 vd4_load_i32(const int* p) {
+    __m128i v = _mm_loadu_si128((const __m128i*)p);
+    vd4 r = {_mm_cvtepi32_pd(v), _mm_cvtepi32_pd(_mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)))};
+    return r;
+}
+static inline vd4 vd4_load_f32(const float* p) {
+    __m128 v = _mm_loadu_ps(p);
+    vd4 r = {_mm_cvtps_pd(v), _mm_cvtps_pd(_mm_movehl_ps(v, v))};
+    return r;
+}
+static inline vd4 vd4_mul(vd4 a, vd4 b) { vd4 r = {_mm_mul_pd(a.lo, b.lo), _mm_mul_pd(a.hi, b.hi)}; return r; }
+static inline vd4 vd4_add(vd4 a, vd4 b) { vd4 r = {_mm_add_pd(a.lo, b.lo), _mm_add_pd(a.hi, b.hi)}; return r; }
+static inline double vd4_sum(vd4 a) {
+    __m128d s = _mm_add_pd(a.lo, a.hi);
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+static inline int vi4_less_mask(const int* p, int threshold) {
+    __m128i lt = _mm_cmplt_epi32(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi32(threshold));
+    return _mm_movemask_ps(_mm_castsi128_ps(lt));
+}
+#endif
+#endif // INVENTORY_SIMD_LANES
+
+// Sum of quantity * price over every product
+double column_total_value() {
+    const int n = columns.count;
+    int i = 0;
+    double total = 0.0;
+#ifdef INVENTORY_SIMD_LANES
+    vd4 acc = vd4_zero();
+    for (; i + 4 <= n; i += 4) {
+        acc = vd4_add(acc, vd4_mul(vd4_load_i32(columns.quantity + i), vd4_load_f32(columns.price + i)));
+    }
+    total = vd4_sum(acc);
+#endif
+    for (; i < n; i++) {
+        total += (double)columns.quantity[i] * columns.price[i];
+    }
+    return total;
+}
+
+// Sum of quantity over every product
+double column_total_units() {
+    const int n = columns.count;
+    int i = 0;
+    double total = 0.0;
+#ifdef INVENTORY_SIMD_LANES
+    vd4 acc = vd4_zero();
+    for (; i + 4 <= n; i += 4) {
+        acc = vd4_add(acc, vd4_load_i32(columns.quantity + i));
+    }
+    total = vd4_sum(acc);
+#endif
+    for (; i < n; i++) {
+        total += columns.quantity[i];
+    }
+    return total;
+}
+
+// Writes rows with quantity < threshold into `rows` (if not NULL) and returns how many matched
+int column_scan_low_stock(int threshold, int* rows) {
+    const int n = columns.count;
+    int i = 0, matched = 0;
+#ifdef INVENTORY_SIMD_LANES
+    for (; i + 4 <= n; i += 4) {
+        int mask = vi4_less_mask(columns.quantity + i, threshold);
+        while (mask) {
+            int lane = mask & 1 ? 0 : mask & 2 ? 1 : mask & 4 ? 2 : 3;
+            if (rows) rows[matched] = i + lane;
+            matched++;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; i < n; i++) {
+        if (columns.quantity[i] < threshold) {
+            if (rows) rows[matched] = i;
+            matched++;
+        }
+    }
+    return matched;
+}
+
+// Per-dimension sums weighted by stock: sums[0..2] = sum(length|width|height * quantity),
+// sums[3] = sum(length * width * height * quantity). Products without dimensions add 0.
+void column_dimension_sums(double sums[4]) {
+    const int n = columns.count;
+    int i = 0;
+    sums[0] = sums[1] = sums[2] = sums[3] = 0.0;
+#ifdef INVENTORY_SIMD_LANES
+    vd4 acc_l = vd4_zero(), acc_w = vd4_zero(), acc_h = vd4_zero(), acc_v = vd4_zero();
+    for (; i + 4 <= n; i += 4) {
+        vd4 q = vd4_load_i32(columns.quantity + i);
+        vd4 l = vd4_mul(vd4_load_i32(columns.length + i), q);
+        vd4 w = vd4_load_i32(columns.width + i);
+        vd4 h = vd4_load_i32(columns.height + i);
+        acc_l = vd4_add(acc_l, l);
+        acc_w = vd4_add(acc_w, vd4_mul(w, q));
+        acc_h = vd4_add(acc_h, vd4_mul(h, q));
+        acc_v = vd4_add(acc_v, vd4_mul(vd4_mul(l, w), h));
+    }
+    sums[0] = vd4_sum(acc_l);
+    sums[1] = vd4_sum(acc_w);
+    sums[2] = vd4_sum(acc_h);
+    sums[3] = vd4_sum(acc_v);
+#endif
+    for (; i < n; i++) {
+        double q = columns.quantity[i];
+        sums[0] += columns.length[i] * q;
+        sums[1] += columns.width[i] * q;
+        sums[2] += columns.height[i] * q;
+        sums[3] += (double)columns.length[i] * columns.width[i] * columns.height[i] * q;
+    }
+}
+
+void print_valuation_report() {
+    if (columns.count == 0) {
+        printf("Cannot build a valuation report. Inventory is empty.\n");
+        flush_output();
+        return;
+    }
+    double dims[4];
+    column_dimension_sums(dims);
+    printf("\n--- Valuation Report (%s) ---\n", INVENTORY_SIMD_NAME);
+    printf("Products:            %d\n", columns.count);
+    printf("Units in stock:      %.0f\n", column_total_units());
+    printf("Total stock value:   %.2f\n", column_total_value());
+    printf("Stocked length sum:  %.0f\n", dims[0]);
+    printf("Stocked width sum:   %.0f\n", dims[1]);
+    printf("Stocked height sum:  %.0f\n", dims[2]);
+    printf("Stocked volume:      %.0f\n", dims[3]);
+    flush_output();
+}
+
+void print_low_stock_scan(int threshold) {
+    int* rows = (int*)malloc((columns.count ? columns.count : 1) * sizeof(int));
+    if (!rows) {
+        printf("Memory allocation failed for low-stock scan.\n");
+        flush_output();
+        return;
+    }
+    int matched = column_scan_low_stock(threshold, rows);
+    printf("\n--- Products with quantity below %d ---\n", threshold);
+    for (int i = 0; i < matched; i++) {
+        printf("%-20s%d\n", columns.strings + columns.name_offset[rows[i]], columns.quantity[rows[i]]);
+    }
+    printf("%d product(s) below threshold.\n", matched);
+    flush_output();
+    free(rows);
+}
+
+// --- Ordered Index Maintenance ---
+
+static SkipNode* skip_node_alloc(int level) {
+    SkipNode* node = skip_free_lists[level];
+    if (node) {
+        skip_free_lists[level] = node->forward[0];
+        return node;
+    }
+    size_t bytes = (sizeof(SkipNode) + level * sizeof(SkipNode*) + 7) & ~(size_t)7;
+    if (!skip_chunks || skip_chunks->used + bytes > SKIP_ARENA_CHUNK) {
+        SkipArenaChunk* chunk = (SkipArenaChunk*)malloc(sizeof(SkipArenaChunk));
+        if (!chunk) {
+            return NULL;
+        }
+        chunk->next_chunk = skip_chunks;
+        chunk->used = 0;
+        skip_chunks = chunk;
+    }
+    node = (SkipNode*)(skip_chunks->data + skip_chunks->used);
+    skip_chunks->used += bytes;
+    node->level = level;
+    return node;
+}
+
+static void skip_node_free(SkipNode* node) {
+    node->forward[0] = skip_free_lists[node->level];
+    skip_free_lists[node->level] = node;
+}
+
+// Geometric height with p = 1/4
+static int skip_random_level() {
+    int level = 1;
+    skip_seed ^= skip_seed << 13;
+    skip_seed ^= skip_seed >> 17;
+    skip_seed ^= skip_seed << 5;
+    for (unsigned int bits = skip_seed; (bits & 3) == 0 && level < SKIP_MAX_LEVEL; bits >>= 2) {
+        level++;
+    }
+    return level;
+}
+
+static int skip_less(const SkipNode* a, double key, const Node* node) {
+    return a->key < key || (a->key == key && a->node < node);
+}
+
+static int skip_init(SkipList* list) {
+    list->header = skip_node_alloc(SKIP_MAX_LEVEL);
+    if (!list->header) {
+        return 0;
+    }
+    for (int i = 0; i < SKIP_MAX_LEVEL; i++) list->header->forward[i] = NULL;
+    list->level = 1;
+    list->count = 0;
+    return 1;
+}
+
+int skip_insert(SkipList* list, double key, Node* node) {
+    if (!list->header && !skip_init(list)) {
+        return 0;
+    }
+    SkipNode* update[SKIP_MAX_LEVEL];
+    SkipNode* x = list->header;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->forward[i] && skip_less(x->forward[i], key, node)) x = x->forward[i];
+        update[i] = x;
+    }
+    int level = skip_random_level();
+    SkipNode* entry = skip_node_alloc(level);
+    if (!entry) {
+        return 0;
+    }
+    for (int i = list->level; i < level; i++) update[i] = list->header;
+    if (level > list->level) list->level = level;
+    entry->key = key;
+    entry->node = node;
+    for (int i = 0; i < level; i++) {
+        entry->forward[i] = update[i]->forward[i];
+        update[i]->forward[i] = entry;
+    }
+    list->count++;
+    return 1;
+}
+
+void skip_remove(SkipList* list, double key, Node* node) {
+    if (!list->header) {
+        return;
+    }
+    SkipNode* update[SKIP_MAX_LEVEL];
+    SkipNode* x = list->header;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->forward[i] && skip_less(x->forward[i], key, node)) x = x->forward[i];
+        update[i] = x;
+    }
+    x = x->forward[0];
+    if (!x || x->node != node) {
+        return;
+    }
+    for (int i = 0; i < x->level; i++) {
+        update[i]->forward[i] = x->forward[i];
+    }
+    while (list->level > 1 && !list->header->forward[list->level - 1]) list->level--;
+    list->count--;
+    skip_node_free(x);
+}
+
+// First entry with key >= `key`
+SkipNode* skip_lower_bound(const SkipList* list, double key) {
+    if (!list->header) {
+        return NULL;
+    }
+    SkipNode* x = list->header;
+    for (int i = list->level - 1; i >= 0; i--) {
+        while (x->forward[i] && x->forward[i]->key < key) x = x->forward[i];
+    }
+    return x->forward[0];
+}
+
+// Releases both ordered indexes at once by freeing the arena chunks
+void ordered_index_clear() {
+    while (skip_chunks) {
+        SkipArenaChunk* chunk = skip_chunks;
+        skip_chunks = chunk->next_chunk;
+        free(chunk);
+    }
+    memset(skip_free_lists, 0, sizeof(skip_free_lists));
+    memset(&price_index, 0, sizeof(price_index));
+    memset(&quantity_index, 0, sizeof(quantity_index));
+}
+
+typedef struct {
+    double key;
+    Node* node;
+} SkipBuildEntry;
+
+static int compare_skip_build_entries(const void* a, const void* b) {
+    const SkipBuildEntry* x = (const SkipBuildEntry*)a;
+    const SkipBuildEntry* y = (const SkipBuildEntry*)b;
+    if (x->key != y->key) return x->key < y->key ? -1 : 1;
+    return x->node < y->node ? -1 : x->node > y->node;
+}
+
+// Builds a skip list from entries sorted ascending, appending at the tail of each level
+static int skip_build_sorted(SkipList* list, const SkipBuildEntry* entries, int count) {
+    if (!skip_init(list)) {
+        return 0;
+    }
+    SkipNode* tail[SKIP_MAX_LEVEL];
+    for (int i = 0; i < SKIP_MAX_LEVEL; i++) tail[i] = list->header;
+    for (int e = 0; e < count; e++) {
+        int level = skip_random_level();
+        SkipNode* entry = skip_node_alloc(level);
+        if (!entry) {
+            return 0;
+        }
+        entry->key = entries[e].key;
+        entry->node = entries[e].node;
+        for (int i = 0; i < level; i++) {
+            entry->forward[i] = NULL;
+            tail[i]->forward[i] = entry;
+            tail[i] = entry;
+        }
+        if (level > list->level) list->level = level;
+        list->count++;
+    }
+    return 1;
+}
+
+// Rebuilds both ordered indexes from the columnar store with one sort each (used by bulk loads)
+int ordered_index_rebuild() {
+    ordered_index_clear();
+    int n = columns.count;
+    SkipBuildEntry* entries = (SkipBuildEntry*)malloc((n ? n : 1) * sizeof(SkipBuildEntry));
+    if (!entries) {
+        return 0;
+    }
+    for (int row = 0; row < n; row++) {
+        entries[row].key = columns.price[row];
+        entries[row].node = columns.row_node[row];
+    }
+    qsort(entries, n, sizeof(SkipBuildEntry), compare_skip_build_entries);
+    int ok = skip_build_sorted(&price_index, entries, n);
+    for (int row = 0; row < n; row++) {
+        entries[row].key = columns.quantity[row];
+        entries[row].node = columns.row_node[row];
+    }
+    qsort(entries, n, sizeof(SkipBuildEntry), compare_skip_build_entries);
+    ok = ok && skip_build_sorted(&quantity_index, entries, n);
+    free(entries);
+    return ok;
+}
+
+// --- Name Trie Maintenance ---
+
+static int trie_new_node(unsigned char ch) {
+    if (trie_count == trie_capacity) {
+        int capacity = trie_capacity ? trie_capacity * 2 : 4096;
+        TrieNode* nodes = (TrieNode*)realloc(trie_nodes, capacity * sizeof(TrieNode));
+        if (!nodes) {
+            return -1;
+        }
+        trie_nodes = nodes;
+        trie_capacity = capacity;
+    }
+    TrieNode* node = &trie_nodes[trie_count];
+    node->first_child = node->next_sibling = -1;
+    node->live = node->terminal = 0;
+    node->ch = ch;
+    return trie_count++;
+}
+
+// Child of `parent` for `ch`, creating it in sorted position when `create` is set
+static int trie_child(int parent, unsigned char ch, int create) {
+    int prev = -1;
+    int child = trie_nodes[parent].first_child;
+    while (child != -1 && trie_nodes[child].ch < ch) {
+        prev = child;
+        child = trie_nodes[child].next_sibling;
+    }
+    if (child != -1 && trie_nodes[child].ch == ch) {
+        return child;
+    }
+    if (!create) {
+        return -1;
+    }
+    int node = trie_new_node(ch); // May move trie_nodes
+    if (node == -1) {
+        return -1;
+    }
+    trie_nodes[node].next_sibling = child;
+    if (prev == -1)
+        trie_nodes[parent].first_child = node;
+    else
+        trie_nodes[prev].next_sibling = node;
+    return node;
+}
+
+void name_trie_clear() {
+    free(trie_nodes);
+    trie_nodes = NULL;
+    trie_count = trie_capacity = 0;
+    name_trie_built = 0;
+}
+
+static int name_trie_add(const char* name) {
+    int node = 0;
+    trie_nodes[0].live++;
+    for (const unsigned char* c = (const unsigned char*)name; *c; c++) {
+        node = trie_child(node, *c, 1);
+        if (node == -1) {
+            return 0;
+        }
+        trie_nodes[node].live++;
+    }
+    trie_nodes[node].terminal++;
+    return 1;
+}
+
+// Keeps a built trie in sync; does nothing until the first query builds it
+void name_trie_insert(const char* name) {
+    if (name_trie_built && !name_trie_add(name)) {
+        name_trie_clear(); // Rebuilt on the next query
+    }
+}
+
+void name_trie_remove(const char* name) {
+    if (!name_trie_built) {
+        return;
+    }
+    int node = 0;
+    trie_nodes[0].live--;
+    for (const unsigned char* c = (const unsigned char*)name; *c && node != -1; c++) {
+        node = trie_child(node, *c, 0);
+        if (node != -1) trie_nodes[node].live--;
+    }
+    if (node != -1) trie_nodes[node].terminal--;
+}
+
+static int name_trie_build() {
+    name_trie_clear();
+    if (trie_new_node(0) == -1) {
+        return 0;
+    }
+    for (int row = 0; row < columns.count; row++) {
+        if (!name_trie_add(columns.strings + columns.name_offset[row])) {
+            name_trie_clear();
+            return 0;
+        }
+    }
+    name_trie_built = 1;
+    return 1;
+}
+
+typedef struct {
+    char name[50];
+    int distance;
+} Suggestion;
+
+typedef struct {
+    Suggestion items[SUGGEST_MAX_RESULTS];
+    int count;
+    int limit;
+    char path[50];
+} SuggestionSet;
+
+// Adds a candidate, keeping the `limit` best by (distance, name)
+static void suggestion_add(SuggestionSet* set, int length, int distance) {
+    for (int i = 0; i < set->count; i++) {
+        if (strncmp(set->items[i].name, set->path, length) == 0 && set->items[i].name[length] == '\0') {
+            if (distance < set->items[i].distance) set->items[i].distance = distance;
+            return;
+        }
+    }
+    int slot = set->count;
+    if (set->count == set->limit) {
+        slot = 0;
+        for (int i = 1; i < set->count; i++) {
+            if (set->items[i].distance > set->items[slot].distance) slot = i;
+        }
+        if (set->items[slot].distance <= distance) return;
+    } else {
+        set->count++;
+    }
+    memcpy(set->items[slot].name, set->path, length);
+    set->items[slot].name[length] = '\0';
+    set->items[slot].distance = distance;
+}
+
+static void trie_collect_prefix(int node, int depth, SuggestionSet* set) {
+    if (trie_nodes[node].terminal > 0) {
+        suggestion_add(set, depth, 0);
+    }
+    for (int child = trie_nodes[node].first_child; child != -1 && set->count < set->limit; child = trie_nodes[child].next_sibling) {
+        if (trie_nodes[child].live > 0 && depth < 49) {
+            set->path[depth] = (char)trie_nodes[child].ch;
+            trie_collect_prefix(child, depth + 1, set);
+        }
+    }
+}
+
+// Levenshtein DFS: each level extends the previous DP row by one trie character and
+// stops descending once every entry in the row exceeds the edit budget
+static void trie_collect_fuzzy(int node, int depth, const char* query, int query_len, const int* prev_row,
+                               int max_edits, SuggestionSet* set) {
+    int row[51];
+    for (int child = trie_nodes[node].first_child; child != -1; child = trie_nodes[child].next_sibling) {
+        if (trie_nodes[child].live == 0 || depth >= 49) continue;
+        unsigned char ch = trie_nodes[child].ch;
+        row[0] = prev_row[0] + 1;
+        int best = row[0];
+        for (int j = 1; j <= query_len; j++) {
+            int substitute = prev_row[j - 1] + ((unsigned char)query[j - 1] != ch);
+            int insert = row[j - 1] + 1;
+            int remove = prev_row[j] + 1;
+            row[j] = substitute < insert ? substitute : insert;
+            if (remove < row[j]) row[j] = remove;
+            if (row[j] < best) best = row[j];
+        }
+        set->path[depth] = (char)ch;
+        if (trie_nodes[child].terminal > 0 && row[query_len] <= max_edits) {
+            suggestion_add(set, depth + 1, row[query_len]);
+        }
+        if (best <= max_edits) {
+            trie_collect_fuzzy(child, depth + 1, query, query_len, row, max_edits, set);
+        }
+    }
+}
+
+static int compare_suggestions(const void* a, const void* b) {
+    const Suggestion* x = (const Suggestion*)a;
+    const Suggestion* y = (const Suggestion*)b;
+    if (x->distance != y->distance) return x->distance - y->distance;
+    return strcmp(x->name, y->name);
+}
+
+// Fills `set` with names starting with `query`, then names within `max_edits` edits of it
+static int name_trie_suggest(const char* query, int max_edits, int limit, SuggestionSet* set) {
+    set->count = 0;
+    set->limit = limit < 1 ? 1 : limit > SUGGEST_MAX_RESULTS ? SUGGEST_MAX_RESULTS : limit;
+    TRIE_LOCK(); // Callers hold the store read lock, so only other readers can be here
+    if (!name_trie_built && !name_trie_build()) {
+        TRIE_UNLOCK();
+        return 0;
+    }
+    int query_len = (int)strlen(query);
+    if (query_len > 49) query_len = 49;
+
+    int node = 0;
+    for (int i = 0; i < query_len && node != -1; i++) {
+        node = trie_child(node, (unsigned char)query[i], 0);
+    }
+    if (node != -1 && trie_nodes[node].live > 0) {
+        memcpy(set->path, query, query_len);
+        trie_collect_prefix(node, query_len, set);
+    }
+    if (max_edits > 0 && set->count < set->limit) {
+        int row[51];
+        for (int j = 0; j <= query_len; j++) row[j] = j;
+        trie_collect_fuzzy(0, 0, query, query_len, row, max_edits, set);
+    }
+    TRIE_UNLOCK();
+    qsort(set->items, set->count, sizeof(Suggestion), compare_suggestions);
+    return set->count;
+}
+
+// Prints "Did you mean ...?" for a name that was not found
+void print_name_suggestions(const char* name) {
+    SuggestionSet set;
+    if (name_trie_suggest(name, 2, 3, &set) > 0) {
+        printf("Did you mean:");
+        for (int i = 0; i < set.count; i++) {
+            printf("%s '%s'", i ? "," : "", set.items[i].name);
+        }
+        printf("?\n");
+    }
+}
+
+// --- Running Aggregates ---
+// Unit and value totals plus the set of products below the reorder threshold, adjusted by the
+// core insert/remove/set functions so the summary and alerts commands never scan. Value is
+// kept in integer cents so adding and removing a product's contribution cannot drift.
+#define DEFAULT_REORDER_THRESHOLD 5
+
+static long long aggregate_units = 0;
+static long long aggregate_value_cents = 0;
+static int reorder_threshold = DEFAULT_REORDER_THRESHOLD;
+static Node** low_stock_nodes = NULL; // Products with quantity < reorder_threshold, unordered
+static int low_stock_count = 0;
+static int low_stock_capacity = 0;
+static int aggregate_verify_mode = 0; // Recompute and check after every mutating input
+static int aggregate_verify_failures = 0; // Checks that found a mismatch in verify mode
+
+static long long product_value_cents(int quantity, float price) {
+    return llround((double)quantity * price * 100.0);
+}
+
+// Room for `count` members, so moving a product into the set later cannot fail
+static int low_stock_reserve(int count) {
+    if (count <= low_stock_capacity) {
+        return 1;
+    }
+    int capacity = low_stock_capacity ? low_stock_capacity : 256;
+    while (capacity < count) capacity *= 2;
+    Node** nodes = (Node**)realloc(low_stock_nodes, capacity * sizeof(Node*));
+    if (!nodes) {
+        return 0;
+    }
+    low_stock_nodes = nodes;
+    low_stock_capacity = capacity;
+    return 1;
+}
+
+static void aggregate_add(Node* node) {
+    aggregate_units += node_quantity(node);
+    aggregate_value_cents += product_value_cents(node_quantity(node), node_price(node));
+    node->low_stock_slot = -1;
+    if (node_quantity(node) < reorder_threshold) {
+        node->low_stock_slot = low_stock_count;
+        low_stock_nodes[low_stock_count++] = node;
+    }
+}
+
+static void aggregate_subtract(Node* node) {
+    aggregate_units -= node_quantity(node);
+    aggregate_value_cents -= product_value_cents(node_quantity(node), node_price(node));
+    if (node->low_stock_slot >= 0) { // Swap-remove from the set
+        Node* last = low_stock_nodes[--low_stock_count];
+        low_stock_nodes[node->low_stock_slot] = last;
+        last->low_stock_slot = node->low_stock_slot;
+        node->low_stock_slot = -1;
+    }
+}
+
+void aggregate_clear() {
+    free(low_stock_nodes);
+    low_stock_nodes = NULL;
+    low_stock_count = low_stock_capacity = 0;
+    aggregate_units = 0;
+    aggregate_value_cents = 0;
+}
+
+// A new threshold changes membership for everyone, so the set is rebuilt from the columns
+void set_reorder_threshold(int threshold) {
+    reorder_threshold = threshold;
+    low_stock_count = 0;
+    for (int row = 0; row < columns.count; row++) {
+        Node* node = columns.row_node[row];
+        node->low_stock_slot = -1;
+        if (columns.quantity[row] < threshold) {
+            node->low_stock_slot = low_stock_count;
+            low_stock_nodes[low_stock_count++] = node;
+        }
+    }
+}
+
+// Recomputes every aggregate from the list and compares. Returns 1 when they all match.
+int inventory_verify_aggregates() {
+    long long units = 0;
+    long long value_cents = 0;
+    int low_stock = 0;
+    int members_ok = 1;
+    for (Node* node = head; node; node = node->next) {
+        units += node_quantity(node);
+        value_cents += product_value_cents(node_quantity(node), node_price(node));
+        if (node_quantity(node) < reorder_threshold) {
+            low_stock++;
+            members_ok &= node->low_stock_slot >= 0 && node->low_stock_slot < low_stock_count &&
+                          low_stock_nodes[node->low_stock_slot] == node;
+        } else {
+            members_ok &= node->low_stock_slot == -1;
+        }
+    }
+    if (units == aggregate_units && value_cents == aggregate_value_cents && low_stock == low_stock_count && members_ok) {
+        return 1;
+    }
+    printf("Aggregate mismatch: units %lld/%lld, cents %lld/%lld, low-stock %d/%d, set %s\n",
+           aggregate_units, units, aggregate_value_cents, value_cents, low_stock_count, low_stock,
+           members_ok ? "ok" : "corrupt");
+    flush_output();
+    return 0;
+}
+
+// Turns on recompute-and-check after every mutating input, for testing
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void set_inventory_verify_mode(int enabled) {
+    aggregate_verify_mode = enabled;
+}
+
+void print_inventory_summary() {
+    printf("\n--- Inventory Summary ---\n");
+    printf("Products:            %d\n", columns.count);
+    printf("Units in stock:      %lld\n", aggregate_units);
+    printf("Total stock value:   %.2f\n", aggregate_value_cents / 100.0);
+    printf("Below reorder level: %d (threshold %d)\n", low_stock_count, reorder_threshold);
+    flush_output();
+}
+
+void print_low_stock_alerts() {
+    printf("\n--- Reorder Alerts (quantity below %d) ---\n", reorder_threshold);
+    for (int i = 0; i < low_stock_count; i++) {
+        printf("%-20s%d\n", node_name(low_stock_nodes[i]), node_quantity(low_stock_nodes[i]));
+    }
+    printf("%d product(s) need reordering.\n", low_stock_count);
+    flush_output();
+}
+
+// Milliseconds from a monotonic clock, used for timing reports
+double now_ms() {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+void print_main_menu() {
+    printf("\nInventory Management System\n");
+    printf("1. Add product\n");
+    printf("2. Display products\n");
+    printf("3. Update product quantity\n");
+    printf("4. Update product price\n");
+    printf("5. Delete product\n");
+    printf("6. Exit\n");
+    printf("7. Memory usage\n");
+    printf("8. Valuation report\n");
+    printf("9. Low-stock scan\n");
+    printf("10. Journal stats\n");
+    printf("11. Range query by quantity or price\n");
+    printf("12. Display sorted by quantity or price\n");
+    printf("13. Inventory summary\n");
+    printf("14. Reorder alerts\n");
+    printf("15. Set reorder threshold\n");
+    printf("Enter your choice:\n");
+    flush_output();
+}
+
+void reset_to_main_menu() {
+    session->operation = OP_MAIN_MENU;
+    session->step = 0;
+    if (session->active && !batch_running) {
+        print_main_menu();
+    }
+}
+
+// --- Core Logic Functions (modified or new) ---
+
+// Journal record types
+#define JOURNAL_OP_ADD 1
+#define JOURNAL_OP_QUANTITY 2
+#define JOURNAL_OP_PRICE 3
+#define JOURNAL_OP_DELETE 4
+#define JOURNAL_OP_CLEAR 5 // init_inventory emptied the store; carries no product
+
+static void journal_log(int op, const Product* product); // Defined with the journal below
+static void journal_log_node(int op, const Node* node);
+void journal_poll();
+int journal_flush_due();
+void close_inventory_journal();
+void print_journal_stats();
+
+// --- Buffered Rendering ---
+// Tables are formatted into one reusable buffer instead of a printf per field. The display
+// menu writes it to stdout in large chunks; render_inventory_page returns it to the caller.
+#define RENDER_BUFFER_STORAGE INVENTORY_THREAD_LOCAL // One buffer per thread so concurrent readers can render
+#include "../common/render_buffer.h"
+
+// "%-*.2f" via integer cents; falls back to snprintf outside the exactly representable range
+static void render_fixed2(double value, int width) {
+    char text[48];
+    int n = 0;
+    if (!(value > -9.0e15 && value < 9.0e15)) {
+        n = snprintf(text, sizeof(text), "%.2f", value);
+        render_bytes(text, (size_t)n, width);
+        return;
+    }
+    long long cents = (long long)nearbyint(value * 100.0); // Ties to even, like printf
+    unsigned long long magnitude = (unsigned long long)(cents < 0 ? -cents : cents);
+    if (cents < 0 || (cents == 0 && signbit(value))) text[n++] = '-';
+    n += format_uint(text + n, magnitude / 100);
+    text[n++] = '.';
+    text[n++] = (char)('0' + magnitude / 10 % 10);
+    text[n++] = (char)('0' + magnitude % 10);
+    render_bytes(text, (size_t)n, width);
+}
+
+static void render_product_row(int row) {
+    render_text(columns.strings + columns.name_offset[row], 20);
+    render_int(columns.quantity[row], 12);
+    render_fixed2(columns.price[row], 10);
+    if (columns.description[row] == 0) {
+        render_int(columns.length[row], 0);
+        render_bytes("x", 1, 0);
+        render_int(columns.width[row], 0);
+        render_bytes("x", 1, 0);
+        render_int(columns.height[row], 0);
+    } else {
+        render_text(columns.strings + intern_entries[columns.description[row] - 1].offset, 0);
+    }
+    render_bytes("\n", 1, 0);
+}
+
+static const char render_rule[] = "----------------------------------------------------------\n";
+
+static void render_table_header() {
+    render_text("Name                Quantity    Price       Details\n", 0);
+    render_text(render_rule, 0);
+}
+
+void displayProducts_internal() { // Renamed to avoid conflict if we export original
+    if (!head) {
+        printf("Cannot display any products. Inventory is empty.\n");
+        flush_output();
+        return;
+    }
+    render_used = 0;
+    render_text("\n--- Current Inventory ---\n", 0);
+    render_table_header();
+    for (Node* temp = head; temp; temp = temp->next) {
+        render_product_row(temp->column_row);
+        if (render_used >= RENDER_CHUNK_BYTES) render_flush();
+    }
+    render_text(render_rule, 0);
+    render_flush();
+    flush_output();
+}
+
+// Number of products, for callers paging through render_inventory_page
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int inventory_row_count() {
+    return columns.count;
+}
+
+// Formats products [offset, offset + limit) in display order as a table and returns it without
+// printing anything. The returned buffer is reused by the next render.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+const char* render_inventory_page(int offset, int limit) {
+    STORE_READ_LOCK();
+    int total = columns.count;
+    if (offset < 0) offset = 0;
+    if (limit < 0) limit = 0;
+    Node* node = head;
+    for (int i = 0; i < offset && node; i++) node = node->next;
+
+    render_used = 0;
+    render_table_header();
+    int shown = 0;
+    for (; node && shown < limit; node = node->next, shown++) {
+        render_product_row(node->column_row);
+    }
+    render_text(render_rule, 0);
+    if (shown > 0) {
+        render_text("Rows ", 0);
+        render_int(offset + 1, 0);
+        render_bytes("-", 1, 0);
+        render_int(offset + shown, 0);
+    } else {
+        render_text("No rows", 0);
+    }
+    render_text(" of ", 0);
+    render_int(total, 0);
+    render_bytes("\n", 1, 0);
+    STORE_UNLOCK();
+    if (!render_reserve(0)) {
+        return "";
+    }
+    render_buffer[render_used] = '\0';
+    return render_buffer;
+}
+
+// Lists products with lo <= field <= hi in ascending order (all of them when lo/hi are infinite)
+void print_ordered_products(int field, double lo, double hi) {
+    const SkipList* list = field == FIELD_PRICE ? &price_index : &quantity_index;
+    int shown = 0;
+    render_used = 0;
+    render_text(field == FIELD_PRICE ? "\n--- Products by price ---\n" : "\n--- Products by quantity ---\n", 0);
+    render_table_header();
+    for (SkipNode* x = skip_lower_bound(list, lo); x && x->key <= hi; x = x->forward[0]) {
+        render_product_row(x->node->column_row);
+        if (render_used >= RENDER_CHUNK_BYTES) render_flush();
+        shown++;
+    }
+    render_text(render_rule, 0);
+    render_flush();
+    printf("%d product(s).\n", shown);
+    flush_output();
+}
+
+// Links a copy of `product` at the head of the list and indexes it. Returns NULL on allocation failure.
+Node* inventory_insert(const Product* product) {
+    Node* newNode = node_pool_alloc();
+    if (!newNode) {
+        return NULL;
+    }
+    newNode->prev = NULL;
+    newNode->next = head;
+    if (head) {
+        head->prev = newNode;
+    }
+    head = newNode;
+    if (!low_stock_reserve(columns.count + 1) || !column_append(newNode, product) || !name_index_insert(newNode) ||
+        (!ordered_index_deferred &&
+         (!skip_insert(&price_index, product->price, newNode) ||
+          !skip_insert(&quantity_index, product->quantity, newNode)))) {
+        skip_remove(&price_index, product->price, newNode);
+        if (columns.count && columns.row_node[columns.count - 1] == newNode) {
+            name_index_remove(newNode);
+            column_remove(newNode);
+        }
+        head = newNode->next;
+        if (head) {
+            head->prev = NULL;
+        }
+        node_pool_free(newNode);
+        return NULL;
+    }
+    name_trie_insert(node_name(newNode));
+    aggregate_add(newNode);
+    journal_log(JOURNAL_OP_ADD, product);
+    return newNode;
+}
+
+// Unlinks and frees a node, keeping the name index in sync
+void inventory_remove(Node* node) {
+    journal_log_node(JOURNAL_OP_DELETE, node);
+    aggregate_subtract(node);
+    name_index_remove(node);
+    name_trie_remove(node_name(node));
+    skip_remove(&price_index, node_price(node), node);
+    skip_remove(&quantity_index, node_quantity(node), node);
+    column_remove(node);
+    if (node->prev)
+        node->prev->next = node->next;
+    else
+        head = node->next;
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    store_generation++;
+    node_pool_free(node);
+}
+
+// Frees every product and empties the index. Slabs are released whole, no list walk.
+void inventory_clear() {
+    node_pool_release_all();
+    head = NULL;
+    name_index_clear();
+    column_clear();
+    ordered_index_clear();
+    name_trie_clear();
+    aggregate_clear();
+    store_generation++;
+}
+
+// Field setters keep the ordered indexes and aggregates in sync with the record. The entry
+// under the new key is added before the old one is removed, so on allocation failure the
+// product stays unchanged and indexed. Return 0 in that case.
+int inventory_set_quantity(Node* node, int quantity) {
+    if (!skip_insert(&quantity_index, quantity, node)) {
+        return 0;
+    }
+    skip_remove(&quantity_index, node_quantity(node), node);
+    aggregate_subtract(node);
+    columns.quantity[node->column_row] = quantity;
+    aggregate_add(node);
+    journal_log_node(JOURNAL_OP_QUANTITY, node);
+    return 1;
+}
+
+int inventory_set_price(Node* node, float price) {
+    if (!skip_insert(&price_index, price, node)) {
+        return 0;
+    }
+    skip_remove(&price_index, node_price(node), node);
+    aggregate_subtract(node);
+    columns.price[node->column_row] = price;
+    aggregate_add(node);
+    journal_log_node(JOURNAL_OP_PRICE, node);
+    return 1;
+}
+
+// The update target cached in step 0, looked up again if another session deleted products since
+static Node* session_target() {
+    if (session->target && session->target_generation != store_generation) {
+        session->target = name_index_find(session->name);
+        session->target_generation = store_generation;
+    }
+    return session->target;
+}
+
+void finalize_add_product() {
+    if (!inventory_insert(&session->product)) {
+        printf("Memory allocation failed for new product.\n");
+        flush_output();
+        return;
+    }
+    printf("Product '%s' added successfully!\n", session->product.name);
+    flush_output();
+}
+
+void handle_add_product_step(const char* input) {
+    switch (session->step) {
+        case 0: // Expecting product name
+            strncpy(session->product.name, input, 49);
+            session->product.name[49] = '\0';
+            session->step++;
+            printf("Enter quantity for '%s': \n", session->product.name);
+            break;
+        case 1: // Expecting quantity
+            session->product.quantity = atoi(input);
+            session->step++;
+            printf("Enter price for '%s': \n", session->product.name);
+            break;
+        case 2: // Expecting price
+            session->product.price = atof(input);
+            session->step++;
+            printf("Does '%s' have dimensions (0 - No, 1 - Yes): \n", session->product.name);
+            break;
+        case 3: // Expecting hasDimensions
+            session->product.hasDimensions = atoi(input);
+            if (session->product.hasDimensions != 0 && session->product.hasDimensions != 1) {
+                 printf("Invalid choice for dimensions. Assuming No (0).\n");
+                 session->product.hasDimensions = 0;
+            }
+            if (session->product.hasDimensions) {
+                session->step++; // Move to step 4 for length
+                printf("Enter length for '%s': \n", session->product.name);
+            } else {
+                session->step = 7; // Skip to step 7 for description
+                printf("Enter product description for '%s': \n", session->product.name);
+            }
+            break;
+        case 4: // Expecting length
+            session->product.details.dimensions.length = atoi(input);
+            session->step++;
+            printf("Enter width for '%s': \n", session->product.name);
+            break;
+        case 5: // Expecting width
+            session->product.details.dimensions.width = atoi(input);
+            session->step++;
+            printf("Enter height for '%s': \n", session->product.name);
+            break;
+        case 6: // Expecting height
+            session->product.details.dimensions.height = atoi(input);
+            finalize_add_product();
+            reset_to_main_menu();
+            break;
+        case 7: // Expecting description
+            strncpy(session->product.details.description, input, 99);
+            session->product.details.description[99] = '\0';
+            finalize_add_product();
+            reset_to_main_menu();
+            break;
+    }
+    flush_output();
+}
+
+void handle_update_quantity_step(const char* input) {
+    switch (session->step) {
+        case 0: // Expecting product name
+            strncpy(session->name, input, 49);
+            session->name[49] = '\0';
+            session->target = name_index_find(session->name);
+            session->target_generation = store_generation;
+            if (session->target) {
+                session->step++;
+                printf("Enter new quantity for '%s' (current: %d): ", session->name, node_quantity(session->target));
+                flush_output();
+                return;
+            }
+            printf("Product '%s' not found.\n", session->name);
+            print_name_suggestions(session->name);
+            flush_output();
+            reset_to_main_menu();
+            break;
+        case 1: // Expecting new quantity
+            if (session_target()) { // Cached from step 0, no second search unless a delete intervened
+                if (inventory_set_quantity(session->target, atoi(input))) {
+                    printf("Quantity for '%s' updated to %d.\n", session->name, node_quantity(session->target));
+                } else {
+                    printf("Memory allocation failed; quantity for '%s' unchanged.\n", session->name);
+                }
+                flush_output();
+                session->target = NULL;
+                reset_to_main_menu();
+                return;
+            }
+            // Should not happen if name was found in step 0
+            printf("Error: Product '%s' lost during update.\n", session->name);
+            flush_output();
+            reset_to_main_menu();
+            break;
+    }
+}
+
+void handle_update_price_step(const char* input) {
+     switch (session->step) {
+        case 0: // Expecting product name
+            strncpy(session->name, input, 49);
+            session->name[49] = '\0';
+            session->target = name_index_find(session->name);
+            session->target_generation = store_generation;
+            if (session->target) {
+                session->step++;
+                printf("Enter new price for '%s' (current: %.2f): ", session->name, node_price(session->target));
+                flush_output();
+                return;
+            }
+            printf("Product '%s' not found.\n", session->name);
+            print_name_suggestions(session->name);
+            flush_output();
+            reset_to_main_menu();
+            break;
+        case 1: // Expecting new price
+            if (session_target()) {
+                if (inventory_set_price(session->target, atof(input))) {
+                    printf("Price for '%s' updated to %.2f.\n", session->name, node_price(session->target));
+                } else {
+                    printf("Memory allocation failed; price for '%s' unchanged.\n", session->name);
+                }
+                flush_output();
+                session->target = NULL;
+                reset_to_main_menu();
+                return;
+            }
+            printf("Error: Product '%s' lost during update.\n", session->name);
+            flush_output();
+            reset_to_main_menu();
+            break;
+    }
+}
+
+void handle_low_stock_step(const char* input) {
+    print_low_stock_scan(atoi(input));
+    reset_to_main_menu();
+}
+
+void handle_range_query_step(const char* input) {
+    switch (session->step) {
+        case 0: // Expecting field
+            session->query_field = atoi(input) == FIELD_PRICE ? FIELD_PRICE : FIELD_QUANTITY;
+            session->step++;
+            printf("Enter minimum %s: \n", session->query_field == FIELD_PRICE ? "price" : "quantity");
+            break;
+        case 1: // Expecting minimum
+            session->query_min = atof(input);
+            session->step++;
+            printf("Enter maximum %s: \n", session->query_field == FIELD_PRICE ? "price" : "quantity");
+            break;
+        case 2: // Expecting maximum
+            print_ordered_products(session->query_field, session->query_min, atof(input));
+            reset_to_main_menu();
+            break;
+    }
+    flush_output();
+}
+
+void handle_sorted_display_step(const char* input) {
+    int field = atoi(input) == FIELD_PRICE ? FIELD_PRICE : FIELD_QUANTITY;
+    print_ordered_products(field, -HUGE_VAL, HUGE_VAL);
+    reset_to_main_menu();
+}
+
+void handle_set_threshold_step(const char* input) {
+    set_reorder_threshold(atoi(input));
+    printf("Reorder threshold set to %d; %d product(s) below it.\n", reorder_threshold, low_stock_count);
+    flush_output();
+    reset_to_main_menu();
+}
+
+void handle_delete_product_step(const char* input_name) {
+    Node* temp = name_index_find(input_name);
+    if (temp) {
+        inventory_remove(temp);
+        printf("Product '%s' deleted successfully!\n", input_name);
+    } else {
+        printf("Product '%s' not found for deletion.\n", input_name);
+        print_name_suggestions(input_name);
+    }
+    flush_output();
+    reset_to_main_menu(); // Always reset after attempting deletion
+}
+
+
+// --- Emscripten Interface Functions ---
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void init_inventory() {
+    // Free any existing list if re-initializing (e.g. component re-mount). An open journal
+    // records the clear, so recovery does not bring the earlier products back.
+    STORE_WRITE_LOCK();
+    journal_log(JOURNAL_OP_CLEAR, NULL);
+    inventory_clear();
+    STORE_UNLOCK();
+
+    session->active = 1;
+    session->operation = OP_MAIN_MENU;
+    session->step = 0;
+    print_main_menu();
+}
+
+// Whether the next input in the session's current state can change the store. Everything
+// else (lookups, reports, scans, moving between menu steps) runs under the shared read lock.
+static int session_input_writes(const InventorySession* s) {
+    switch (s->operation) {
+        case OP_MAIN_MENU:
+            return 0; // Exit from the default session releases the store after unlocking
+        case OP_ADD_PRODUCT:
+            return s->step == 6 || s->step == 7; // Height or description completes the product
+        case OP_UPDATE_QUANTITY:
+        case OP_UPDATE_PRICE:
+            return s->step == 1;
+        case OP_DELETE_PRODUCT:
+        case OP_SET_THRESHOLD:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+static void session_handle_input(const char* input_str);
+void shutdown_inventory();
+
+// Starts a native operator session at the main menu
+InventorySession* inventory_session_create() {
+    InventorySession* s = (InventorySession*)calloc(1, sizeof(InventorySession));
+    if (s) {
+        s->active = 1;
+        s->operation = OP_MAIN_MENU;
+        s->query_field = FIELD_QUANTITY;
+        STORE_WRITE_LOCK();
+        created_sessions++;
+        STORE_UNLOCK();
+    }
+    return s;
+}
+
+void inventory_session_destroy(InventorySession* s) {
+    if (s && s != &default_session) {
+        STORE_WRITE_LOCK();
+        created_sessions--;
+        STORE_UNLOCK();
+        free(s);
+    }
+}
+
+// Feeds one line of input to `s`. Safe to call from several threads, one session per thread
+// at a time: the store is locked shared or exclusive depending on what the input can do.
+// When the default session exits while no created session is open, as in the browser, the
+// store is shut down as well.
+void inventory_session_input(InventorySession* s, const char* input_str) {
+    InventorySession* previous = session;
+    int writes = session_input_writes(s);
+    int was_active = s->active;
+    session = s;
+    if (writes) {
+        STORE_WRITE_LOCK();
+        journal_poll();
+    } else {
+        STORE_READ_LOCK();
+    }
+    session_handle_input(input_str);
+    if (writes && aggregate_verify_mode && !inventory_verify_aggregates()) {
+        aggregate_verify_failures++;
+    }
+    int last_exit = was_active && !s->active && s == &default_session && created_sessions == 0;
+    STORE_UNLOCK();
+    if (last_exit) {
+        shutdown_inventory();
+    } else if (!writes && journal_flush_due()) { // Group commit deadlines still apply to read-only traffic
+        STORE_WRITE_LOCK();
+        journal_poll();
+        STORE_UNLOCK();
+    }
+    session = previous;
+}
+
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void process_inventory_input(const char* input_str) {
+    flush_output();
+    inventory_session_input(&default_session, input_str);
+}
+
+// Copies the product called `name` into `out` under the shared lock. Returns 0 if there is none.
+int inventory_lookup(const char* name, Product* out) {
+    STORE_READ_LOCK();
+    Node* node = name_index_find(name);
+    if (node) {
+        column_read_product(node->column_row, out);
+    }
+    STORE_UNLOCK();
+    return node != NULL;
+}
+
+// Sets the quantity of the product called `name` under the exclusive lock. Returns 0 if there
+// is none or the update failed.
+int inventory_update_quantity(const char* name, int quantity) {
+    STORE_WRITE_LOCK();
+    Node* node = name_index_find(name);
+    int updated = node && inventory_set_quantity(node, quantity);
+    STORE_UNLOCK();
+    return updated;
+}
+
+static void session_handle_input(const char* input_str) {
+    if (!session->active) {
+        printf("Inventory session has ended. Please re-initialize to start a new session.\n");
+        flush_output();
+        return;
+    }
+
+    if (session->operation == OP_MAIN_MENU) {
+        int choice = atoi(input_str);
+        switch (choice) {
+            case 1: // Add product
+                session->operation = OP_ADD_PRODUCT;
+                session->step = 0;
+                printf("Enter product name: \n");
+                flush_output();
+                break;
+            case 2: // Display products
+                displayProducts_internal();
+                reset_to_main_menu(); // Stay in main menu, just re-prompt
+                break;
+            case 3: // Update product quantity
+                session->operation = OP_UPDATE_QUANTITY;
+                session->step = 0;
+                printf("Enter product name to update quantity: \n");
+                flush_output();
+                break;
+            case 4: // Update product price
+                session->operation = OP_UPDATE_PRICE;
+                session->step = 0;
+                printf("Enter product name to update price: \n");
+                flush_output();
+                break;
+            case 5: // Delete product
+                session->operation = OP_DELETE_PRODUCT;
+                session->step = 0; // Step 0 will ask for name
+                printf("Enter product name to delete: \n");
+                flush_output();
+                break;
+            case 6: // Exit: the store outlives this session unless it was the only one
+                session->active = 0;
+                printf("Session ended.\n");
+                flush_output();
+                break;
+            case 7: // Memory usage
+                print_memory_usage();
+                reset_to_main_menu();
+                break;
+            case 8: // Valuation report
+                print_valuation_report();
+                reset_to_main_menu();
+                break;
+            case 9: // Low-stock scan
+                session->operation = OP_LOW_STOCK_SCAN;
+                session->step = 0;
+                printf("Enter low-stock threshold: \n");
+                flush_output();
+                break;
+            case 10: // Journal stats
+                print_journal_stats();
+                reset_to_main_menu();
+                break;
+            case 11: // Range query
+                session->operation = OP_RANGE_QUERY;
+                session->step = 0;
+                printf("Query by (1 - Quantity, 2 - Price): \n");
+                flush_output();
+                break;
+            case 12: // Sorted display
+                session->operation = OP_SORTED_DISPLAY;
+                session->step = 0;
+                printf("Sort by (1 - Quantity, 2 - Price): \n");
+                flush_output();
+                break;
+            case 13: // Summary from running aggregates
+                print_inventory_summary();
+                reset_to_main_menu();
+                break;
+            case 14: // Reorder alerts
+                print_low_stock_alerts();
+                reset_to_main_menu();
+                break;
+            case 15: // Set reorder threshold
+                session->operation = OP_SET_THRESHOLD;
+                session->step = 0;
+                printf("Enter reorder threshold (current: %d): \n", reorder_threshold);
+                flush_output();
+                break;
+            default:
+                printf("Invalid choice. Please try again.\n");
+                flush_output();
+                reset_to_main_menu(); // Re-prompt main menu
+                break;
+        }
+    } else if (session->operation == OP_ADD_PRODUCT) {
+        handle_add_product_step(input_str);
+    } else if (session->operation == OP_UPDATE_QUANTITY) {
+        handle_update_quantity_step(input_str);
+    } else if (session->operation == OP_UPDATE_PRICE) {
+        handle_update_price_step(input_str);
+    } else if (session->operation == OP_DELETE_PRODUCT) {
+        // For delete, we get the name directly, no further steps needed from user after this input
+        handle_delete_product_step(input_str);
+    } else if (session->operation == OP_LOW_STOCK_SCAN) {
+        handle_low_stock_step(input_str);
+    } else if (session->operation == OP_RANGE_QUERY) {
+        handle_range_query_step(input_str);
+    } else if (session->operation == OP_SORTED_DISPLAY) {
+        handle_sorted_display_step(input_str);
+    } else if (session->operation == OP_SET_THRESHOLD) {
+        handle_set_threshold_step(input_str);
+    }
+}
+
+// Runs newline-delimited commands in one call, handling each non-empty line as
+// process_inventory_input would. The main menu is not repeated after every command: it is
+// printed once at the end, and output is flushed once. A line over BATCH_LINE_MAX
+// characters stops the script with an error rather than being cut short.
+#define BATCH_LINE_MAX 255
+
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void process_inventory_batch(const char* lines, int len) {
+    char line[BATCH_LINE_MAX + 1];
+    int line_number = 0;
+    const char* end = lines + len;
+    batch_running = 1;
+    for (const char* p = lines; p < end;) {
+        const char* newline = memchr(p, '\n', (size_t)(end - p));
+        if (!newline) newline = end;
+        size_t n = (size_t)(newline - p);
+        if (n > 0 && p[n - 1] == '\r') n--;
+        line_number++;
+        if (n > BATCH_LINE_MAX) {
+            printf("Script stopped: line %d is longer than %d characters.\n", line_number, BATCH_LINE_MAX);
+            break;
+        }
+        if (n > 0) {
+            memcpy(line, p, n);
+            line[n] = '\0';
+            process_inventory_input(line);
+        }
+        p = newline + 1;
+    }
+    batch_running = 0;
+    if (session->active && session->operation == OP_MAIN_MENU) {
+        print_main_menu();
+    }
+    fflush(stdout);
+}
+
+// --- Name Suggestions ---
+
+// Newline-separated product names starting with `query`, followed by names within
+// `max_edits` edits of it, best first. The returned buffer is reused by the next call.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+const char* suggest_inventory_names(const char* query, int max_edits, int limit) {
+    SuggestionSet set;
+    size_t used = 0;
+    STORE_READ_LOCK();
+    name_trie_suggest(query, max_edits, limit, &set);
+    STORE_UNLOCK();
+    for (int i = 0; i < set.count; i++) {
+        size_t len = strlen(set.items[i].name);
+        memcpy(suggestion_buffer + used, set.items[i].name, len);
+        used += len;
+        suggestion_buffer[used++] = '\n';
+    }
+    suggestion_buffer[used] = '\0';
+    return suggestion_buffer;
+}
+
+// Suggestions for whatever the user is typing, when the current step expects an existing
+// product name; empty otherwise. Meant to be called by the runner on every keystroke.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+const char* suggest_inventory_input(const char* partial) {
+    int wants_name = (session->operation == OP_UPDATE_QUANTITY || session->operation == OP_UPDATE_PRICE ||
+                      session->operation == OP_DELETE_PRODUCT) && session->step == 0;
+    if (!session->active || !wants_name || partial[0] == '\0') {
+        suggestion_buffer[0] = '\0';
+        return suggestion_buffer;
+    }
+    return suggest_inventory_names(partial, 2, 8);
+}
+
+// --- Bulk Import ---
+// CSV rows, one product per line:
+//   name,quantity,price,0,description          (description runs to the end of the line)
+//   name,quantity,price,1,length,width,height
+// A first line with no numeric field is treated as a header and skipped; any other bad row,
+// first or not, is counted as rejected.
+// Fields are parsed straight out of the caller's buffer; only the final name and
+// description bytes are copied, into the product itself.
+
+// Trims spaces around [*start, *end)
+static void trim_field(const char** start, const char** end) {
+    while (*start < *end && (**start == ' ' || **start == '\t')) (*start)++;
+    while (*end > *start && ((*end)[-1] == ' ' || (*end)[-1] == '\t' || (*end)[-1] == '\r')) (*end)--;
+}
+
+// Parses an optionally signed decimal integer filling the whole field
+static int parse_int_field(const char* p, const char* end, int* out) {
+    trim_field(&p, &end);
+    int negative = 0;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (p == end) return 0;
+    long long value = 0;
+    for (; p < end; p++) {
+        if (*p < '0' || *p > '9' || value > 2147483647LL) return 0;
+        value = value * 10 + (*p - '0');
+    }
+    *out = (int)(negative ? -value : value);
+    return 1;
+}
+
+// Parses a plain decimal number (no exponent) filling the whole field
+static int parse_float_field(const char* p, const char* end, float* out) {
+    trim_field(&p, &end);
+    int negative = 0, digits = 0;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    double value = 0.0, scale = 1.0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++, digits++) value = value * 10.0 + (*p - '0');
+    if (p < end && *p == '.') {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++, digits++) value += (*p - '0') * (scale *= 0.1);
+    }
+    if (p != end || digits == 0) return 0;
+    *out = (float)(negative ? -value : value);
+    return 1;
+}
+
+// Copies [p, end) into a fixed-size, NUL-terminated field, truncating like the interactive path
+static void copy_text_field(char* dest, size_t size, const char* p, const char* end) {
+    trim_field(&p, &end);
+    size_t len = (size_t)(end - p);
+    if (len > size - 1) len = size - 1;
+    memcpy(dest, p, len);
+    dest[len] = '\0';
+}
+
+// A header names its columns, so none of its fields is a number
+static int csv_row_is_header(const char* p, const char* end) {
+    float value;
+    for (const char* field = p; field <= end;) {
+        const char* field_end = memchr(field, ',', (size_t)(end - field));
+        if (!field_end) field_end = end;
+        if (parse_float_field(field, field_end, &value)) {
+            return 0;
+        }
+        field = field_end + 1;
+    }
+    return 1;
+}
+
+// Parses one line into `product`. Returns 0 for malformed rows.
+static int parse_product_row(const char* p, const char* end, Product* product) {
+    const char* fields[7];
+    const char* field_ends[7];
+    int count = 0;
+    fields[0] = p;
+    for (const char* c = p; c < end && count < 7; c++) {
+        // Fields after "hasDimensions=0" are the free-text description; stop splitting there
+        if (*c == ',' && !(count == 4 && *fields[3] == '0')) {
+            field_ends[count++] = c;
+            if (count < 7) fields[count] = c + 1;
+        }
+    }
+    if (count < 7) field_ends[count++] = end;
+    if (count < 5) return 0;
+
+    copy_text_field(product->name, sizeof(product->name), fields[0], field_ends[0]);
+    if (product->name[0] == '\0' ||
+        !parse_int_field(fields[1], field_ends[1], &product->quantity) ||
+        !parse_float_field(fields[2], field_ends[2], &product->price) ||
+        !parse_int_field(fields[3], field_ends[3], &product->hasDimensions)) {
+        return 0;
+    }
+    if (product->hasDimensions == 1) {
+        return count == 7 &&
+               parse_int_field(fields[4], field_ends[4], &product->details.dimensions.length) &&
+               parse_int_field(fields[5], field_ends[5], &product->details.dimensions.width) &&
+               parse_int_field(fields[6], field_ends[6], &product->details.dimensions.height);
+    }
+    if (product->hasDimensions != 0) return 0;
+    copy_text_field(product->details.description, sizeof(product->details.description), fields[4], end);
+    return 1;
+}
+
+// Imports every row of a CSV buffer in one call. Returns the number of products added.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int import_inventory_csv(const char* buf, size_t len) {
+    double start = now_ms();
+    const char* end = buf + len;
+
+    // Size the pool, index and columns once for the whole batch
+    int line_count = 1;
+    for (const char* c = memchr(buf, '\n', len); c; c = memchr(c + 1, '\n', (size_t)(end - c - 1))) {
+        line_count++;
+    }
+    if (!node_pool_reserve(line_count) || !name_index_reserve((unsigned int)line_count) ||
+        (columns.count + line_count > columns.capacity && !column_grow(columns.count + line_count))) {
+        printf("Memory allocation failed during import.\n");
+        flush_output();
+        return 0;
+    }
+
+    int imported = 0, rejected = 0, first_row = 1;
+    Product product;
+    memset(&product, 0, sizeof(product));
+    ordered_index_deferred = 1;
+    name_trie_clear(); // Rebuilt in one pass on the next suggestion query
+    for (const char* line = buf; line < end;) {
+        const char* line_end = memchr(line, '\n', (size_t)(end - line));
+        if (!line_end) line_end = end;
+        const char* trimmed_end = line_end;
+        if (trimmed_end > line && trimmed_end[-1] == '\r') trimmed_end--;
+
+        if (trimmed_end > line) {
+            if (parse_product_row(line, trimmed_end, &product)) {
+                if (inventory_insert(&product)) {
+                    imported++;
+                } else {
+                    printf("Memory allocation failed during import.\n");
+                    break;
+                }
+            } else if (!first_row || !csv_row_is_header(line, trimmed_end)) {
+                rejected++;
+            }
+            first_row = 0;
+        }
+        line = line_end + 1;
+    }
+    ordered_index_deferred = 0;
+    if (imported > 0 && !ordered_index_rebuild()) {
+        printf("Memory allocation failed rebuilding ordered indexes.\n");
+    }
+
+    double elapsed = now_ms() - start;
+    printf("Imported %d product(s), %d row(s) rejected, in %.1f ms (%.0f rows/sec).\n",
+           imported, rejected, elapsed, elapsed > 0 ? (imported + rejected) * 1000.0 / elapsed : 0.0);
+    flush_output();
+    return imported;
+}
+
+// File-path variant: reads the whole file and imports it in one call
+int import_inventory_file(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        printf("Error opening file: %s\n", path);
+        flush_output();
+        return -1;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* buf = (char*)malloc(size > 0 ? (size_t)size : 1);
+    if (!buf || fread(buf, 1, (size_t)size, file) != (size_t)size) {
+        printf("Error reading file: %s\n", path);
+        flush_output();
+        free(buf);
+        fclose(file);
+        return -1;
+    }
+    fclose(file);
+    int imported = import_inventory_csv(buf, (size_t)size);
+    free(buf);
+    return imported;
+}
+
+// --- Binary Snapshots ---
+// A snapshot is a fixed-layout image of the store. Loading is not a replay of adds, but it
+// is not a zero-copy map either: records are still copied into the columns one by one
+// (names and descriptions re-enter the string arena), list links and the ordered indexes
+// are restored in sequential passes without sorting, and the name index is rebuilt by
+// hashing each name once:
+//   SnapshotHeader
+//   Product records[count]                 in columnar row order
+//   uint32_t list_order[count]             rows from head to tail
+//   uint32_t price_order[count]            rows in price-index order
+//   uint32_t quantity_order[count]         rows in quantity-index order
+// Equal keys are stored in ascending row order, which is node address order once loaded,
+// so the ordered indexes are rebuilt without sorting. The checksum covers everything after the header.
+#define SNAPSHOT_MAGIC 0x53564E49u // "INVS"
+#define SNAPSHOT_VERSION 3
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t count;
+    uint32_t reserved;         // Zero
+    uint32_t journal_sequence; // Last journal record already reflected in this snapshot
+    uint64_t checksum;
+} SnapshotHeader;
+
+static uint32_t journal_sequence = 0;          // Sequence number of the last journal record written
+static uint32_t snapshot_journal_sequence = 0; // journal_sequence of the most recently loaded snapshot
+
+// Fletcher-style sums over 32-bit words, wrapping at 2^32 so there is no division in the loop.
+// Every section is a multiple of 4 bytes.
+typedef struct {
+    uint32_t a, b;
+} SnapshotChecksum;
+
+static void snapshot_checksum_update(SnapshotChecksum* sum, const void* data, size_t len) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint32_t a = sum->a, b = sum->b;
+    for (size_t i = 0; i + 4 <= len; i += 4) {
+        uint32_t word;
+        memcpy(&word, bytes + i, 4);
+        a += word;
+        b += a;
+    }
+    sum->a = a;
+    sum->b = b;
+}
+
+static int snapshot_write(FILE* file, SnapshotChecksum* sum, const void* data, size_t len) {
+    snapshot_checksum_update(sum, data, len);
+    return len == 0 || fwrite(data, 1, len, file) == len;
+}
+
+static int compare_rows(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Rows in index order, with each run of equal keys sorted by row
+static void snapshot_ordered_rows(const SkipList* list, uint32_t* rows) {
+    int n = 0, run_start = 0;
+    double run_key = 0.0;
+    for (SkipNode* x = list->header ? list->header->forward[0] : NULL; x; x = x->forward[0]) {
+        if (n == 0 || x->key != run_key) {
+            qsort(rows + run_start, n - run_start, sizeof(uint32_t), compare_rows);
+            run_start = n;
+            run_key = x->key;
+        }
+        rows[n++] = (uint32_t)x->node->column_row;
+    }
+    qsort(rows + run_start, n - run_start, sizeof(uint32_t), compare_rows);
+}
+
+// Builds an ordered index from rows already in index order; nodes[row] holds each row
+static int snapshot_build_ordered(SkipList* list, const uint32_t* rows, size_t count, Node* nodes, int field) {
+    SkipBuildEntry* entries = (SkipBuildEntry*)malloc(count * sizeof(SkipBuildEntry));
+    if (!entries) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (rows[i] >= count) {
+            free(entries);
+            return 0;
+        }
+        entries[i].node = &nodes[rows[i]];
+        entries[i].key = field == FIELD_PRICE ? (double)columns.price[rows[i]] : columns.quantity[rows[i]];
+    }
+    int ok = skip_build_sorted(list, entries, (int)count);
+    free(entries);
+    return ok;
+}
+
+// Writes the whole inventory to `path` (via a temp file and rename). Returns the record count or -1.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int save_inventory_snapshot(const char* path) {
+    char temp_path[512];
+    snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    int count = columns.count;
+    FILE* file = fopen(temp_path, "wb");
+    Product* records = (Product*)malloc((count ? count : 1) * sizeof(Product));
+    uint32_t* rows = (uint32_t*)malloc((count ? count : 1) * sizeof(uint32_t));
+    if (!file || !records || !rows) {
+        printf("Error opening snapshot for writing: %s\n", path);
+        flush_output();
+        if (file) fclose(file);
+        free(records);
+        free(rows);
+        return -1;
+    }
+
+    SnapshotHeader header = {SNAPSHOT_MAGIC, SNAPSHOT_VERSION, sizeof(Product), (uint32_t)count, 0, journal_sequence, 0};
+    SnapshotChecksum sum = {0, 0};
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    for (int row = 0; row < count; row++) {
+        column_read_product(row, &records[row]);
+    }
+    ok = ok && snapshot_write(file, &sum, records, count * sizeof(Product));
+
+    int i = 0;
+    for (Node* temp = head; temp; temp = temp->next) {
+        rows[i++] = (uint32_t)temp->column_row;
+    }
+    ok = ok && snapshot_write(file, &sum, rows, count * sizeof(uint32_t));
+
+    snapshot_ordered_rows(&price_index, rows);
+    ok = ok && snapshot_write(file, &sum, rows, count * sizeof(uint32_t));
+    snapshot_ordered_rows(&quantity_index, rows);
+    ok = ok && snapshot_write(file, &sum, rows, count * sizeof(uint32_t));
+
+    header.checksum = ((uint64_t)sum.b << 32) | sum.a;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = fclose(file) == 0 && ok;
+    free(records);
+    free(rows);
+    if (!ok || rename(temp_path, path) != 0) {
+        printf("Error writing snapshot: %s\n", path);
+        flush_output();
+        remove(temp_path);
+        return -1;
+    }
+    return count;
+}
+
+// Whether `rows` holds every row below `count` exactly once. A repeated row would link or
+// index the same node twice.
+static int snapshot_is_permutation(const uint32_t* rows, size_t count) {
+    unsigned char* seen = (unsigned char*)calloc(count / 8 + 1, 1);
+    int ok = seen != NULL;
+    for (size_t i = 0; ok && i < count; i++) {
+        uint32_t row = rows[i];
+        ok = row < count && !(seen[row / 8] & (1u << (row % 8)));
+        if (ok) seen[row / 8] |= (unsigned char)(1u << (row % 8));
+    }
+    free(seen);
+    return ok;
+}
+
+// Whether every record's strings end inside their fields. Names are copied with strnlen, but
+// descriptions are interned with strlen and must not run past the record.
+static int snapshot_records_terminated(const Product* records, size_t count) {
+    for (size_t row = 0; row < count; row++) {
+        const Product* record = &records[row];
+        if (memchr(record->name, '\0', sizeof(record->name)) == NULL ||
+            (!record->hasDimensions &&
+             memchr(record->details.description, '\0', sizeof(record->details.description)) == NULL)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Validates a snapshot image (mapped or read into memory) and rebuilds the store from it:
+// records are copied into the columns, the list and ordered indexes are restored in
+// sequential passes, and the name index is rebuilt from the names
+static int load_snapshot_image(const unsigned char* image, size_t size) {
+    SnapshotHeader header;
+    if (size < sizeof(header)) return -1;
+    memcpy(&header, image, sizeof(header));
+    size_t count = header.count;
+    if (count > (SIZE_MAX - sizeof(header)) / (sizeof(Product) + 3 * sizeof(uint32_t))) return -1;
+    size_t body = count * (sizeof(Product) + 3 * sizeof(uint32_t));
+    if (header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION ||
+        header.record_size != sizeof(Product) || size != sizeof(header) + body) {
+        return -1;
+    }
+    SnapshotChecksum sum = {0, 0};
+    snapshot_checksum_update(&sum, image + sizeof(header), body);
+    if ((((uint64_t)sum.b << 32) | sum.a) != header.checksum) {
+        return -1;
+    }
+    const Product* records = (const Product*)(image + sizeof(header));
+    const uint32_t* list_order = (const uint32_t*)(records + count);
+    const uint32_t* price_order = list_order + count;
+    const uint32_t* quantity_order = price_order + count;
+    if (!snapshot_records_terminated(records, count) || !snapshot_is_permutation(list_order, count) ||
+        !snapshot_is_permutation(price_order, count) || !snapshot_is_permutation(quantity_order, count)) {
+        return -1;
+    }
+
+    inventory_clear();
+    snapshot_journal_sequence = header.journal_sequence;
+    if (count == 0) return 0;
+    Node* nodes = node_pool_alloc_block((int)count);
+    if (!nodes || !column_grow((int)count) || !low_stock_reserve((int)count) ||
+        !name_index_reserve((unsigned int)count)) {
+        inventory_clear();
+        return -1;
+    }
+
+    // Records and columns: row i lives in nodes[i]
+    for (size_t row = 0; row < count; row++) {
+        if (!column_append(&nodes[row], &records[row])) {
+            inventory_clear();
+            return -1;
+        }
+        aggregate_add(&nodes[row]);
+    }
+
+    // List links, head to tail
+    Node* prev = NULL;
+    for (size_t i = 0; i < count; i++) {
+        Node* node = &nodes[list_order[i]];
+        node->prev = prev;
+        node->next = NULL;
+        if (prev)
+            prev->next = node;
+        else
+            head = node;
+        prev = node;
+    }
+
+    // Name index and duplicate chains, tail to head: the list is newest first, so each
+    // insert puts a newer duplicate in front of the older ones as inventory_insert did
+    for (Node* node = prev; node; node = node->prev) {
+        if (!name_index_insert(node)) {
+            inventory_clear();
+            return -1;
+        }
+    }
+
+    // Ordered indexes, already sorted in the file
+    if (!snapshot_build_ordered(&price_index, price_order, count, nodes, FIELD_PRICE) ||
+        !snapshot_build_ordered(&quantity_index, quantity_order, count, nodes, FIELD_QUANTITY)) {
+        inventory_clear();
+        return -1;
+    }
+    return (int)count;
+}
+
+// Replaces the inventory with a snapshot. Native builds map the file instead of reading it;
+// under Emscripten the file lives in MEMFS and is read in one call. Either way the records
+// are copied into the store. Returns the record count or -1.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int load_inventory_snapshot(const char* path) {
+    int loaded = -1;
+#ifdef __EMSCRIPTEN__
+    FILE* file = fopen(path, "rb");
+    if (file) {
+        fseek(file, 0, SEEK_END);
+        long size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        unsigned char* image = (unsigned char*)malloc(size > 0 ? (size_t)size : 1);
+        if (image && fread(image, 1, (size_t)size, file) == (size_t)size) {
+            loaded = load_snapshot_image(image, (size_t)size);
+        }
+        free(image);
+        fclose(file);
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd != -1 && fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* image = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (image != MAP_FAILED) {
+            madvise(image, (size_t)st.st_size, MADV_SEQUENTIAL);
+            loaded = load_snapshot_image((const unsigned char*)image, (size_t)st.st_size);
+            munmap(image, (size_t)st.st_size);
+        }
+    }
+    if (fd != -1) close(fd);
+#endif
+    if (loaded < 0) {
+        printf("Error loading snapshot: %s (missing, corrupt or wrong version)\n", path);
+        flush_output();
+    }
+    return loaded;
+}
+
+// --- Journal ---
+// Append-only log of every add, quantity/price update, delete and re-init, written with group commit:
+// records collect in memory and reach the file (write + fsync) once `journal_flush_records`
+// are pending or the oldest pending record is `journal_flush_interval_ms` old. The interval is
+// checked on each mutation and each input. Records are fixed-size and checksummed, so a torn
+// tail is detected and dropped on recovery. Sequence numbers tie the log to snapshots: a
+// checkpoint stores the last sequence it covers, and recovery skips records up to it.
+typedef struct {
+    uint32_t op;
+    uint32_t sequence;
+    uint32_t checksum; // Over op, sequence and product
+    Product product;   // Add: the whole product. Others: the name plus the changed field.
+} JournalRecord;
+
+static FILE* journal_file = NULL;
+static JournalRecord* journal_pending = NULL;
+static int journal_pending_count = 0;
+static int journal_flush_records = 64;
+static double journal_flush_interval_ms = 50.0;
+static double journal_oldest_pending_ms = 0.0;
+// When the pending group is due, HUGE_VAL with nothing pending. Atomic so that read-only
+// inputs can check it without taking the store lock.
+static _Atomic double journal_flush_deadline_ms = HUGE_VAL;
+static int journal_replaying = 0; // Set during recovery so replayed mutations are not logged again
+
+// Journal statistics
+static unsigned long journal_stat_records = 0;
+static unsigned long journal_stat_commits = 0;
+static double journal_stat_commit_ms = 0.0;
+static double journal_stat_max_commit_ms = 0.0;
+
+static uint32_t journal_record_checksum(const JournalRecord* record) {
+    SnapshotChecksum sum = {0, 0};
+    snapshot_checksum_update(&sum, &record->op, 2 * sizeof(uint32_t));
+    snapshot_checksum_update(&sum, &record->product, sizeof(Product));
+    return sum.a ^ (sum.b * 2654435761u);
+}
+
+// Writes every pending record and syncs. Returns 0 if the write failed.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int flush_inventory_journal() {
+    if (!journal_file || journal_pending_count == 0) {
+        return 1;
+    }
+    double start = now_ms();
+    int ok = fwrite(journal_pending, sizeof(JournalRecord), journal_pending_count, journal_file) == (size_t)journal_pending_count;
+    ok = fflush(journal_file) == 0 && ok;
+#ifndef __EMSCRIPTEN__
+    ok = fsync(fileno(journal_file)) == 0 && ok;
+#endif
+    double elapsed = now_ms() - start;
+    journal_stat_records += journal_pending_count;
+    journal_stat_commits++;
+    journal_stat_commit_ms += elapsed;
+    if (elapsed > journal_stat_max_commit_ms) journal_stat_max_commit_ms = elapsed;
+    journal_pending_count = 0;
+    journal_flush_deadline_ms = HUGE_VAL;
+    if (!ok) {
+        printf("Error writing inventory journal.\n");
+        flush_output();
+    }
+    return ok;
+}
+
+// Commits the pending group if the flush interval has elapsed
+void journal_poll() {
+    if (journal_pending_count > 0 && now_ms() - journal_oldest_pending_ms >= journal_flush_interval_ms) {
+        flush_inventory_journal();
+    }
+}
+
+// Whether journal_poll would commit now. Safe to call without the store lock.
+int journal_flush_due() {
+    double deadline = journal_flush_deadline_ms;
+    return deadline != HUGE_VAL && now_ms() >= deadline;
+}
+
+// Logs an update or delete of `node`, expanding its record only when a journal is open
+static void journal_log_node(int op, const Node* node) {
+    if (journal_file && !journal_replaying) {
+        Product product;
+        column_read_product(node->column_row, &product);
+        journal_log(op, &product);
+    }
+}
+
+static void journal_log(int op, const Product* product) {
+    if (!journal_file || journal_replaying) {
+        return;
+    }
+    JournalRecord* record = &journal_pending[journal_pending_count];
+    memset(record, 0, sizeof(*record));
+    record->op = (uint32_t)op;
+    record->sequence = ++journal_sequence;
+    if (op == JOURNAL_OP_ADD) {
+        record->product = *product;
+    } else if (op != JOURNAL_OP_CLEAR) {
+        strcpy(record->product.name, product->name);
+        record->product.quantity = product->quantity;
+        record->product.price = product->price;
+    }
+    record->checksum = journal_record_checksum(record);
+    if (journal_pending_count++ == 0) {
+        journal_oldest_pending_ms = now_ms();
+        journal_flush_deadline_ms = journal_oldest_pending_ms + journal_flush_interval_ms;
+    }
+    if (journal_pending_count >= journal_flush_records) {
+        flush_inventory_journal();
+    } else {
+        journal_poll();
+    }
+}
+
+// Starts logging mutations to `path` (appending). A flush_records or flush_interval_ms of 0
+// keeps the current setting.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int open_inventory_journal(const char* path, int flush_records, int flush_interval_ms) {
+    close_inventory_journal();
+    if (flush_records > 0) journal_flush_records = flush_records;
+    if (flush_interval_ms > 0) journal_flush_interval_ms = flush_interval_ms;
+    journal_pending = (JournalRecord*)malloc(journal_flush_records * sizeof(JournalRecord));
+    journal_file = journal_pending ? fopen(path, "ab") : NULL;
+    if (!journal_file) {
+        printf("Error opening inventory journal: %s\n", path);
+        flush_output();
+        free(journal_pending);
+        journal_pending = NULL;
+        return 0;
+    }
+    journal_stat_records = journal_stat_commits = 0;
+    journal_stat_commit_ms = journal_stat_max_commit_ms = 0.0;
+    return 1;
+}
+
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void close_inventory_journal() {
+    if (!journal_file) {
+        return;
+    }
+    flush_inventory_journal();
+    fclose(journal_file);
+    journal_file = NULL;
+    free(journal_pending);
+    journal_pending = NULL;
+}
+
+// Ends the whole store: commits and closes the journal, then frees every product. Exit from
+// the default session calls this when no created session is open; otherwise call it once none
+// of them are using the store any more.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+void shutdown_inventory() {
+    STORE_WRITE_LOCK();
+    close_inventory_journal();
+    inventory_clear();
+    STORE_UNLOCK();
+}
+
+// Writes a snapshot covering everything logged so far, then empties the journal
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int checkpoint_inventory(const char* snapshot_path, const char* journal_path) {
+    if (!flush_inventory_journal() || save_inventory_snapshot(snapshot_path) < 0) {
+        return 0;
+    }
+    // A crash between the rename above and this truncate is harmless: the snapshot's
+    // sequence number makes recovery skip the records it already contains.
+    FILE* truncated = journal_file ? freopen(journal_path, "wb", journal_file) : NULL;
+    if (journal_file && !truncated) {
+        journal_file = NULL;
+        printf("Error truncating inventory journal: %s\n", journal_path);
+        flush_output();
+        return 0;
+    }
+    journal_file = truncated;
+    return 1;
+}
+
+// Applies one logged mutation to the store
+static void journal_apply(const JournalRecord* record) {
+    Node* node;
+    switch (record->op) {
+        case JOURNAL_OP_ADD:
+            inventory_insert(&record->product);
+            break;
+        case JOURNAL_OP_QUANTITY:
+            if ((node = name_index_find(record->product.name))) inventory_set_quantity(node, record->product.quantity);
+            break;
+        case JOURNAL_OP_PRICE:
+            if ((node = name_index_find(record->product.name))) inventory_set_price(node, record->product.price);
+            break;
+        case JOURNAL_OP_DELETE:
+            if ((node = name_index_find(record->product.name))) inventory_remove(node);
+            break;
+        case JOURNAL_OP_CLEAR:
+            inventory_clear();
+            break;
+    }
+}
+
+// Rebuilds the inventory from the latest snapshot plus the journal tail. Stops at the first
+// torn or corrupt record and cuts the journal there so later appends follow valid data.
+// Either file may be missing. Returns the number of journal records replayed.
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int recover_inventory(const char* snapshot_path, const char* journal_path) {
+    FILE* probe = fopen(snapshot_path, "rb");
+    if (probe) {
+        fclose(probe);
+        if (load_inventory_snapshot(snapshot_path) < 0) {
+            return -1;
+        }
+    } else {
+        inventory_clear();
+        snapshot_journal_sequence = 0;
+    }
+    journal_sequence = snapshot_journal_sequence;
+
+    FILE* file = fopen(journal_path, "rb");
+    if (!file) {
+        return 0;
+    }
+    int replayed = 0;
+    long valid_bytes = 0;
+    JournalRecord record;
+    journal_replaying = 1;
+    while (fread(&record, sizeof(record), 1, file) == 1 && record.checksum == journal_record_checksum(&record)) {
+        if (record.sequence > snapshot_journal_sequence) {
+            journal_apply(&record);
+            journal_sequence = record.sequence;
+            replayed++;
+        }
+        valid_bytes += sizeof(record);
+    }
+    journal_replaying = 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    if (size != valid_bytes) {
+#ifdef __EMSCRIPTEN__
+        // No truncate() on MEMFS paths from C: rewrite the valid prefix instead
+        FILE* in = fopen(journal_path, "rb");
+        char* data = (char*)malloc(valid_bytes > 0 ? (size_t)valid_bytes : 1);
+        if (in && data && fread(data, 1, (size_t)valid_bytes, in) == (size_t)valid_bytes) {
+            fclose(in);
+            in = NULL;
+            FILE* out = fopen(journal_path, "wb");
+            if (out) {
+                fwrite(data, 1, (size_t)valid_bytes, out);
+                fclose(out);
+            }
+        }
+        if (in) fclose(in);
+        free(data);
+#else
+        if (truncate(journal_path, valid_bytes) != 0) {
+            printf("Error truncating torn journal tail: %s\n", journal_path);
+        }
+#endif
+        printf("Dropped %ld byte(s) of torn journal tail.\n", size - valid_bytes);
+        flush_output();
+    }
+    return replayed;
+}
+
+void print_journal_stats() {
+    printf("\n--- Journal ---\n");
+    if (!journal_file) {
+        printf("Journal is not open.\n");
+        flush_output();
+        return;
+    }
+    printf("Records committed:  %lu (%d pending)\n", journal_stat_records, journal_pending_count);
+    printf("Group commits:      %lu (%.1f records each)\n", journal_stat_commits,
+           journal_stat_commits ? (double)journal_stat_records / journal_stat_commits : 0.0);
+    printf("Commit latency:     %.3f ms avg, %.3f ms max\n",
+           journal_stat_commits ? journal_stat_commit_ms / journal_stat_commits : 0.0, journal_stat_max_commit_ms);
+    printf("Commit throughput:  %.0f records/sec\n",
+           journal_stat_commit_ms > 0 ? journal_stat_records * 1000.0 / journal_stat_commit_ms : 0.0);
+    flush_output();
+}
+
+// --- Report API ---
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+double inventory_total_value() {
+    STORE_READ_LOCK();
+    double value = column_total_value();
+    STORE_UNLOCK();
+    return value;
+}
+
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+int inventory_count_low_stock(int threshold) {
+    STORE_READ_LOCK();
+    int count = column_scan_low_stock(threshold, NULL);
+    STORE_UNLOCK();
+    return count;
+}
+
+// Stocked volume: sum of length * width * height * quantity over products with dimensions
+#ifdef __EMSCRIPTEN__
+EMSCRIPTEN_KEEPALIVE
+#endif
+double inventory_stocked_volume() {
+    double sums[4];
+    STORE_READ_LOCK();
+    column_dimension_sums(sums);
+    STORE_UNLOCK();
+    return sums[3];
+}
+
+// --- Main function for local command-line testing ---
+#ifndef __EMSCRIPTEN__
+// Original functions that used scanf, for reference or local testing setup
+Product original_createProduct_scanf() {
+    Product p;
+    printf("Enter product name: "); scanf(" %[^\n]", p.name);
+    printf("Enter quantity: "); scanf("%d", &p.quantity);
+    printf("Enter price: "); scanf("%f", &p.price);
+    printf("Does this product have dimensions (0 - No, 1 - Yes): "); scanf("%d", &p.hasDimensions);
+    if (p.hasDimensions) {
+        printf("Enter length, width, and height: ");
+        scanf("%d %d %d", &p.details.dimensions.length, &p.details.dimensions.width, &p.details.dimensions.height);
+    } else {
+        printf("Enter product description: "); scanf(" %[^\n]", p.details.description);
+    }
+    return p;
+}
+
+// Fills the inventory with `count` synthetic products named SKU-0000000, SKU-0000001, ...
+void bench_fill_inventory(int count) {
+    Product p;
+    memset(&p, 0, sizeof(p));
+    for (int i = 0; i < count; i++) {
+        snprintf(p.name, sizeof(p.name), "SKU-%07d", i);
+        p.quantity = i % 500;
+        p.price = (float)(i % 10000) / 100.0f;
+        p.hasDimensions = i & 1;
+        if (p.hasDimensions) {
+            p.details.dimensions.length = 1 + i % 40;
+            p.details.dimensions.width = 1 + i % 30;
+            p.details.dimensions.height = 1 + i % 20;
+        } else {
+            snprintf(p.details.description, sizeof(p.details.description), "Item %d", i);
+        }
+        inventory_insert(&p);
+    }
+}
+
+// Old lookup path, kept here only as the benchmark baseline
+Node* linear_find(const char* name) {
+    for (Node* temp = head; temp; temp = temp->next) {
+        if (strcmp(node_name(temp), name) == 0) return temp;
+    }
+    return NULL;
+}
+
+// Compares indexed and linear name lookups as the inventory grows.
+// Indexed cost should stay flat while the list walk grows with n.
+int run_lookup_benchmark() {
+    static const int sizes[] = {1000, 10000, 100000, 500000};
+    char name[50];
+    int failures = 0;
+    printf("%-10s %-18s %-18s %-12s\n", "Products", "Indexed ns/lookup", "Linear ns/lookup", "Teardown ms");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        int n = sizes[s];
+        inventory_clear();
+        bench_fill_inventory(n);
+
+        int indexed_lookups = 1000000;
+        unsigned int seed = 12345;
+        long found = 0;
+        double start = now_ms();
+        for (int i = 0; i < indexed_lookups; i++) {
+            seed = seed * 1103515245u + 12345u;
+            snprintf(name, sizeof(name), "SKU-%07d", (int)(seed % (unsigned int)n));
+            found += name_index_find(name) != NULL;
+        }
+        double indexed_ns = (now_ms() - start) * 1e6 / indexed_lookups;
+
+        int linear_lookups = n >= 100000 ? 200 : 2000;
+        start = now_ms();
+        for (int i = 0; i < linear_lookups; i++) {
+            seed = seed * 1103515245u + 12345u;
+            snprintf(name, sizeof(name), "SKU-%07d", (int)(seed % (unsigned int)n));
+            found += linear_find(name) != NULL;
+        }
+        double linear_ns = (now_ms() - start) * 1e6 / linear_lookups;
+
+        start = now_ms();
+        inventory_clear();
+        double teardown_ms = now_ms() - start;
+
+        printf("%-10d %-18.1f %-18.1f %-12.3f\n", n, indexed_ns, linear_ns, teardown_ms);
+        if (found != indexed_lookups + linear_lookups) {
+            printf("Benchmark error: %ld of %d lookups found.\n", found, indexed_lookups + linear_lookups);
+            failures++;
+        }
+    }
+    return failures != 0;
+}
+
+// Runs the valuation, low-stock and volume aggregates over 1M products, once by walking
+// the Node list and reading each record through its row (list order, scattered rows) and
+// once streaming the columns.
+int run_column_benchmark() {
+    const int n = 1000000;
+    const int reps = 20;
+    inventory_clear();
+    bench_fill_inventory(n);
+
+    double list_value = 0, list_volume = 0;
+    long list_low = 0;
+    double start = now_ms();
+    for (int r = 0; r < reps; r++) {
+        list_value = list_volume = 0;
+        list_low = 0;
+        for (Node* temp = head; temp; temp = temp->next) {
+            int row = temp->column_row;
+            list_value += (double)columns.quantity[row] * columns.price[row];
+            list_low += columns.quantity[row] < 10;
+            if (columns.description[row] == 0) {
+                list_volume += (double)columns.length[row] * columns.width[row] * columns.height[row] *
+                               columns.quantity[row];
+            }
+        }
+    }
+    double list_ms = (now_ms() - start) / reps;
+
+    double col_value = 0, col_volume = 0;
+    long col_low = 0;
+    start = now_ms();
+    for (int r = 0; r < reps; r++) {
+        double dims[4];
+        col_value = column_total_value();
+        col_low = column_scan_low_stock(10, NULL);
+        column_dimension_sums(dims);
+        col_volume = dims[3];
+    }
+    double col_ms = (now_ms() - start) / reps;
+
+    printf("Products: %d, kernels: %s\n", n, INVENTORY_SIMD_NAME);
+    printf("%-10s %-10s %-18s %-10s %-18s\n", "Store", "ms/pass", "Value", "Low<10", "Volume");
+    printf("%-10s %-10.3f %-18.2f %-10ld %-18.0f\n", "list", list_ms, list_value, list_low, list_volume);
+    printf("%-10s %-10.3f %-18.2f %-10ld %-18.0f\n", "columnar", col_ms, col_value, col_low, col_volume);
+    printf("Speedup: %.1fx\n", list_ms / col_ms);
+    inventory_clear();
+    return 0;
+}
+
+// Builds `count` synthetic CSV rows in the bulk-import format. Caller frees.
+char* bench_build_csv(int count, size_t* len) {
+    size_t capacity = (size_t)count * 64 + 64;
+    char* csv = (char*)malloc(capacity);
+    if (!csv) return NULL;
+    size_t used = (size_t)sprintf(csv, "name,quantity,price,hasDimensions,details\n");
+    for (int i = 0; i < count; i++) {
+        if (i & 1) {
+            used += (size_t)sprintf(csv + used, "SKU-%07d,%d,%d.%02d,1,%d,%d,%d\n", i, i % 500, i % 100, i % 97,
+                                    1 + i % 40, 1 + i % 30, 1 + i % 20);
+        } else {
+            used += (size_t)sprintf(csv + used, "SKU-%07d,%d,%d.%02d,0,Item %d, assorted\n", i, i % 500, i % 100, i % 97, i);
+        }
+    }
+    *len = used;
+    return csv;
+}
+
+// Times a single-call import of 500k rows
+int run_import_benchmark() {
+    size_t len;
+    char* csv = bench_build_csv(500000, &len);
+    if (!csv) return 1;
+    inventory_clear();
+    import_inventory_csv(csv, len);
+    printf("%zu bytes, %zu products in memory.\n", len, node_pool_live);
+    inventory_clear();
+    free(csv);
+    return 0;
+}
+
+// Cold start of 1M products: re-importing the CSV versus loading a binary snapshot
+int run_snapshot_benchmark() {
+    const int n = 1000000;
+    const char* path = "inventory_bench.snapshot";
+    size_t len;
+    char* csv = bench_build_csv(n, &len);
+    if (!csv) return 1;
+
+    inventory_clear();
+    double start = now_ms();
+    import_inventory_csv(csv, len);
+    double import_ms = now_ms() - start;
+
+    start = now_ms();
+    int saved = save_inventory_snapshot(path);
+    double save_ms = now_ms() - start;
+
+    inventory_clear();
+    start = now_ms();
+    int loaded = load_inventory_snapshot(path);
+    double load_ms = now_ms() - start;
+
+    printf("%-22s %10.1f ms\n", "CSV import", import_ms);
+    printf("%-22s %10.1f ms (%d records)\n", "Snapshot save", save_ms, saved);
+    printf("%-22s %10.1f ms (%d records)\n", "Snapshot load", load_ms, loaded);
+    printf("Cold start speedup: %.1fx\n", import_ms / load_ms);
+
+    // Duplicate names come back newest first, and a description without its terminator is
+    // rejected before the store is touched
+    Product p;
+    memset(&p, 0, sizeof(p));
+    inventory_clear();
+    strcpy(p.name, "dup");
+    for (p.quantity = 1; p.quantity <= 3; p.quantity++) inventory_insert(&p);
+    int problems = save_inventory_snapshot(path) != 3 || load_inventory_snapshot(path) != 3;
+    for (int quantity = 3; quantity >= 1; quantity--) {
+        Node* node = name_index_find("dup");
+        problems += !node || node_quantity(node) != quantity;
+        if (node) inventory_remove(node);
+    }
+    problems += name_index_find("dup") != NULL;
+    inventory_insert(&p);
+    FILE* file = save_inventory_snapshot(path) == 1 ? fopen(path, "rb") : NULL;
+    unsigned char image[sizeof(SnapshotHeader) + sizeof(Product) + 3 * sizeof(uint32_t)];
+    if (!file || fread(image, 1, sizeof(image), file) != sizeof(image)) {
+        problems++;
+    } else {
+        SnapshotHeader header;
+        SnapshotChecksum sum = {0, 0};
+        memcpy(&header, image, sizeof(header));
+        memset(image + sizeof(header) + offsetof(Product, details), 'x', sizeof(p.details.description));
+        snapshot_checksum_update(&sum, image + sizeof(header), sizeof(image) - sizeof(header));
+        header.checksum = ((uint64_t)sum.b << 32) | sum.a;
+        memcpy(image, &header, sizeof(header));
+        problems += load_snapshot_image(image, sizeof(image)) != -1 || inventory_row_count() != 1;
+    }
+    if (file) fclose(file);
+    printf("Duplicate order and unterminated description: %s\n", problems ? "FAILED" : "ok");
+    remove(path);
+    inventory_clear();
+    free(csv);
+    return saved != n || loaded != n || problems != 0;
+}
+
+// Applies one step of a deterministic random workload over ~300 names through the core API
+void bench_apply_random_op(unsigned int* seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    unsigned int r = *seed >> 8;
+    Product p;
+    memset(&p, 0, sizeof(p));
+    snprintf(p.name, sizeof(p.name), "SKU-%07u", r % 300);
+    Node* node = name_index_find(p.name);
+    switch ((r >> 12) % 4) {
+        case 0:
+            p.quantity = (int)(r % 100);
+            p.price = (float)(r % 5000) / 100.0f;
+            snprintf(p.details.description, sizeof(p.details.description), "Random item %u", r);
+            inventory_insert(&p);
+            break;
+        case 1:
+            if (node) inventory_set_quantity(node, (int)(r % 1000));
+            break;
+        case 2:
+            if (node) inventory_set_price(node, (float)(r % 9000) / 100.0f);
+            break;
+        case 3:
+            if (node) inventory_remove(node);
+            break;
+    }
+}
+
+// FNV-1a over the list contents, head to tail
+uint64_t inventory_fingerprint() {
+    uint64_t h = 1469598103934665603ULL;
+    Product product;
+    for (Node* temp = head; temp; temp = temp->next) {
+        column_read_product(temp->column_row, &product);
+        const unsigned char* bytes = (const unsigned char*)&product;
+        for (size_t i = 0; i < sizeof(Product); i++) {
+            h = (h ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+    return h;
+}
+
+// Logs a random workload with a checkpoint halfway, then recovers from copies of the
+// journal cut at random offsets (and some with a flipped byte). Every recovery must land
+// exactly on the state recorded after the last intact record.
+int run_journal_crash_test() {
+    const char* snapshot_path = "crash_test.snapshot";
+    const char* journal_path = "crash_test.journal";
+    const char* trial_path = "crash_test_trial.journal";
+    const int ops = 4000;
+    remove(snapshot_path);
+    remove(journal_path);
+
+    uint64_t* expected = (uint64_t*)malloc((ops + 1) * sizeof(uint64_t));
+    if (!expected) return 1;
+    inventory_clear();
+    journal_sequence = 0;
+    if (!open_inventory_journal(journal_path, 16, 1000)) return 1;
+    expected[0] = inventory_fingerprint();
+    unsigned int seed = 2024;
+    uint32_t checkpoint_sequence = 0;
+    double start = now_ms();
+    for (int i = 0; i < ops; i++) {
+        bench_apply_random_op(&seed);
+        expected[journal_sequence] = inventory_fingerprint();
+        if (i == ops / 2) {
+            checkpoint_inventory(snapshot_path, journal_path);
+            checkpoint_sequence = journal_sequence;
+        }
+    }
+    double elapsed = now_ms() - start;
+    print_journal_stats();
+    printf("Workload: %d ops, %u records in %.1f ms\n", ops, journal_sequence, elapsed);
+    close_inventory_journal();
+
+    FILE* file = fopen(journal_path, "rb");
+    fseek(file, 0, SEEK_END);
+    long len = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char* log = (char*)malloc(len > 0 ? (size_t)len : 1);
+    if (!log || fread(log, 1, (size_t)len, file) != (size_t)len) return 1;
+    fclose(file);
+
+    int trials = 200, failures = 0;
+    for (int t = 0; t < trials; t++) {
+        seed = seed * 1103515245u + 12345u;
+        long cut = (long)((seed >> 4) % (unsigned int)(len + 1));
+        long intact = cut / (long)sizeof(JournalRecord);
+        FILE* trial = fopen(trial_path, "wb");
+        fwrite(log, 1, (size_t)cut, trial);
+        if (t % 4 == 3 && intact > 0) {
+            // Flip a byte inside a random intact record; recovery must stop just before it
+            long victim = (long)((seed >> 9) % (unsigned int)intact);
+            long offset = victim * (long)sizeof(JournalRecord) + (long)((seed >> 3) % sizeof(JournalRecord));
+            char byte = log[offset] ^ 0x5A;
+            fseek(trial, offset, SEEK_SET);
+            fwrite(&byte, 1, 1, trial);
+            intact = victim;
+        }
+        fclose(trial);
+
+        int replayed = recover_inventory(snapshot_path, trial_path);
+        uint32_t expected_sequence = checkpoint_sequence + (uint32_t)intact;
+        if (replayed != (int)intact || journal_sequence != expected_sequence ||
+            inventory_fingerprint() != expected[expected_sequence]) {
+            printf("FAIL: cut at %ld, replayed %d of %ld record(s)\n", cut, replayed, intact);
+            failures++;
+        }
+    }
+    printf("Crash recovery: %d/%d trials recovered the expected state.\n", trials - failures, trials);
+
+    // A re-init between two adds is logged, so only the second product comes back
+    Product p;
+    memset(&p, 0, sizeof(p));
+    remove(snapshot_path);
+    remove(journal_path);
+    int reinit_ok = open_inventory_journal(journal_path, 16, 1000);
+    strcpy(p.name, "before re-init");
+    inventory_insert(&p);
+    quiet_stdout_begin(); // init_inventory prints the menu
+    init_inventory();
+    quiet_stdout_end();
+    strcpy(p.name, "after re-init");
+    inventory_insert(&p);
+    close_inventory_journal();
+    reinit_ok = reinit_ok && recover_inventory(snapshot_path, journal_path) == 3 && node_pool_live == 1 &&
+                name_index_find("after re-init") != NULL;
+    printf("Re-init before recovery: %s\n", reinit_ok ? "ok" : "FAILED");
+    failures += !reinit_ok;
+    remove(snapshot_path);
+    remove(journal_path);
+    remove(trial_path);
+    inventory_clear();
+    free(log);
+    free(expected);
+    return failures != 0;
+}
+
+// Narrow price-range queries through the ordered index versus a full list scan
+int run_range_benchmark() {
+    const int n = 1000000;
+    const int queries = 2000;
+    inventory_clear();
+    bench_fill_inventory(n);
+    unsigned int seed = 99;
+    long indexed_hits = 0, scanned_hits = 0;
+    double start = now_ms();
+    for (int q = 0; q < queries; q++) {
+        seed = seed * 1103515245u + 12345u;
+        double lo = (seed >> 8) % 10000 / 100.0, hi = lo + 0.05;
+        for (SkipNode* x = skip_lower_bound(&price_index, lo); x && x->key <= hi; x = x->forward[0]) indexed_hits++;
+    }
+    double indexed_ms = now_ms() - start;
+    seed = 99;
+    start = now_ms();
+    for (int q = 0; q < queries / 100; q++) {
+        seed = seed * 1103515245u + 12345u;
+        double lo = (seed >> 8) % 10000 / 100.0, hi = lo + 0.05;
+        for (Node* temp = head; temp; temp = temp->next) {
+            scanned_hits += node_price(temp) >= lo && node_price(temp) <= hi;
+        }
+    }
+    double scanned_ms = (now_ms() - start) * 100;
+    printf("%d price-range queries over %d products (~%ld hits each)\n", queries, n, indexed_hits / queries);
+    printf("%-14s %10.3f ms/query\n", "ordered index", indexed_ms / queries);
+    printf("%-14s %10.3f ms/query\n", "list scan", scanned_ms / queries);
+    inventory_clear();
+    return 0;
+}
+
+// Prefix and fuzzy suggestion latency over 100k products
+int run_suggest_benchmark() {
+    const int n = 100000;
+    const int queries = 2000;
+    char query[50];
+    inventory_clear();
+    bench_fill_inventory(n);
+    double start = now_ms();
+    name_trie_build();
+    printf("Trie build: %.1f ms, %d nodes for %d names\n", now_ms() - start, trie_count, n);
+
+    unsigned int seed = 5;
+    long results = 0;
+    start = now_ms();
+    for (int q = 0; q < queries; q++) {
+        seed = seed * 1103515245u + 12345u;
+        snprintf(query, sizeof(query), "SKU-%05u", (seed >> 8) % 100000 / 100);
+        results += suggest_inventory_names(query, 0, 8)[0] != '\0';
+    }
+    double prefix_ms = (now_ms() - start) / queries;
+    start = now_ms();
+    for (int q = 0; q < queries; q++) {
+        seed = seed * 1103515245u + 12345u;
+        // A typo: one digit replaced and one dropped
+        snprintf(query, sizeof(query), "SKU-%07u", (seed >> 8) % (unsigned int)n);
+        query[6 + (seed >> 4) % 4] = 'x';
+        memmove(query + 9, query + 10, 2);
+        results += suggest_inventory_names(query, 2, 8)[0] != '\0';
+    }
+    double fuzzy_ms = (now_ms() - start) / queries;
+    printf("%-22s %8.4f ms/query\n", "Prefix (8 results)", prefix_ms);
+    printf("%-22s %8.4f ms/query\n", "Fuzzy <= 2 edits", fuzzy_ms);
+    printf("%ld of %d queries returned suggestions\n", results, 2 * queries);
+    inventory_clear();
+    return 0;
+}
+
+// Formatting 50k rows with a printf per field versus the render buffer, both into /dev/null
+int run_render_benchmark() {
+    const int n = 50000;
+    FILE* sink = fopen("/dev/null", "w");
+    if (!sink) {
+        perror("/dev/null");
+        return 1;
+    }
+    inventory_clear();
+    bench_fill_inventory(n);
+
+    double start = now_ms();
+    Product expanded;
+    for (Node* node = head; node; node = node->next) {
+        const Product* product = &expanded;
+        column_read_product(node->column_row, &expanded);
+        fprintf(sink, "%-20s%-12d%-10.2f", product->name, product->quantity, product->price);
+        if (product->hasDimensions) {
+            fprintf(sink, "%dx%dx%d\n", product->details.dimensions.length,
+                    product->details.dimensions.width, product->details.dimensions.height);
+        } else {
+            fprintf(sink, "%s\n", product->details.description);
+        }
+        fflush(sink);
+    }
+    double printf_ms = now_ms() - start;
+
+    start = now_ms();
+    render_used = 0;
+    for (Node* node = head; node; node = node->next) {
+        render_product_row(node->column_row);
+        if (render_used >= RENDER_CHUNK_BYTES) {
+            fwrite(render_buffer, 1, render_used, sink);
+            render_used = 0;
+        }
+    }
+    fwrite(render_buffer, 1, render_used, sink);
+    render_used = 0;
+    double buffered_ms = now_ms() - start;
+
+    start = now_ms();
+    size_t bytes = strlen(render_inventory_page(n / 2, 50));
+    double page_ms = now_ms() - start;
+
+    printf("%-28s %8.2f ms\n", "printf + fflush per row", printf_ms);
+    printf("%-28s %8.2f ms\n", "Render buffer, 64KB writes", buffered_ms);
+    printf("%-28s %8.3f ms (%zu bytes)\n", "One 50-row page mid-list", page_ms, bytes);
+    fclose(sink);
+    inventory_clear();
+    return 0;
+}
+
+// --- Thread load generator ---
+
+typedef struct {
+    int thread_id;
+    int product_count;
+    int write_percent;
+    atomic_int* stop;
+    unsigned long reads;
+    unsigned long writes;
+} LoadWorker;
+
+static void* load_worker_main(void* arg) {
+    LoadWorker* worker = (LoadWorker*)arg;
+    unsigned int seed = 0x1234567u + (unsigned int)worker->thread_id * 7919u;
+    char name[50];
+    Product product;
+    while (!atomic_load_explicit(worker->stop, memory_order_relaxed)) {
+        for (int batch = 0; batch < 256; batch++) { // Check the stop flag every few hundred ops
+            seed = seed * 1103515245u + 12345u;
+            snprintf(name, sizeof(name), "SKU-%07u", (seed >> 8) % (unsigned int)worker->product_count);
+            if ((int)(seed % 100) < worker->write_percent) {
+                inventory_update_quantity(name, (int)(seed >> 20));
+                worker->writes++;
+            } else {
+                inventory_lookup(name, &product);
+                worker->reads++;
+            }
+        }
+    }
+    return NULL;
+}
+
+typedef struct {
+    int thread_id;
+    int rounds;
+} SessionWorker;
+
+// Drives one session through adds, updates, lookups and deletes of its own and shared names
+static void* session_worker_main(void* arg) {
+    SessionWorker* worker = (SessionWorker*)arg;
+    InventorySession* s = inventory_session_create();
+    char line[64];
+    for (int round = 0; round < worker->rounds && s; round++) {
+        snprintf(line, sizeof(line), "T%d-%d", worker->thread_id, round % 16);
+        const char* add[] = {"1", line, "5", "2.50", "0", "thread stock"};
+        for (int i = 0; i < 6; i++) inventory_session_input(s, add[i]);
+        inventory_session_input(s, "3");
+        snprintf(line, sizeof(line), "SKU-%07d", (worker->thread_id * 31 + round) % 1000);
+        inventory_session_input(s, line);
+        inventory_session_input(s, "42");
+        inventory_session_input(s, round % 4 ? "7" : "8");
+        inventory_session_input(s, "5");
+        snprintf(line, sizeof(line), "T%d-%d", worker->thread_id, (round + 8) % 16);
+        inventory_session_input(s, line);
+    }
+    inventory_session_destroy(s);
+    render_release();
+    return NULL;
+}
+
+// Every product reachable through the list must be indexed, and the columns must agree with it
+static int inventory_consistent() {
+    int count = 0;
+    double units = 0.0;
+    for (Node* node = head; node; node = node->next) {
+        if (name_index_find(node_name(node)) == NULL || columns.row_node[node->column_row] != node) {
+            return 0;
+        }
+        units += node_quantity(node);
+        count++;
+    }
+    return count == columns.count && units == column_total_units();
+}
+
+// Read/write throughput over a shared 100k-product store from 1 to 32 threads
+int run_thread_benchmark() {
+    const int n = 100000;
+    const int thread_counts[] = {1, 2, 4, 8, 16, 32};
+    const int mixes[] = {0, 10, 50};
+    const double run_ms = 200.0;
+    pthread_t threads[32];
+    LoadWorker workers[32];
+
+    inventory_clear();
+    bench_fill_inventory(n);
+    printf("Online CPUs: %ld\n", sysconf(_SC_NPROCESSORS_ONLN));
+    printf("%-8s %-8s %14s %14s %14s\n", "Writes%", "Threads", "Reads/s", "Writes/s", "Total ops/s");
+    for (size_t m = 0; m < sizeof(mixes) / sizeof(mixes[0]); m++) {
+        for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+            int count = thread_counts[t];
+            atomic_int stop = 0;
+            for (int i = 0; i < count; i++) {
+                workers[i] = (LoadWorker){i, n, mixes[m], &stop, 0, 0};
+            }
+            double start = now_ms();
+            for (int i = 0; i < count; i++) {
+                pthread_create(&threads[i], NULL, load_worker_main, &workers[i]);
+            }
+            while (now_ms() - start < run_ms) {
+                usleep(1000);
+            }
+            atomic_store(&stop, 1);
+            unsigned long reads = 0, writes = 0;
+            for (int i = 0; i < count; i++) {
+                pthread_join(threads[i], NULL);
+                reads += workers[i].reads;
+                writes += workers[i].writes;
+            }
+            double seconds = (now_ms() - start) / 1000.0;
+            printf("%-8d %-8d %14.0f %14.0f %14.0f\n", mixes[m], count,
+                   reads / seconds, writes / seconds, (reads + writes) / seconds);
+        }
+    }
+
+    // Sessions through the text protocol, with output muted
+    const int session_threads = 8;
+    SessionWorker session_workers[8];
+    quiet_stdout_begin();
+    double start = now_ms();
+    for (int i = 0; i < session_threads; i++) {
+        session_workers[i] = (SessionWorker){i, 500};
+        pthread_create(&threads[i], NULL, session_worker_main, &session_workers[i]);
+    }
+    for (int i = 0; i < session_threads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double session_ms = now_ms() - start;
+    quiet_stdout_end();
+    int consistent = inventory_consistent();
+    printf("%d concurrent sessions x 500 rounds: %.1f ms, store %s\n", session_threads, session_ms,
+           consistent ? "consistent" : "INCONSISTENT");
+    inventory_clear();
+    return !consistent;
+}
+
+// Random workload with every aggregate recomputed and checked after each step, plus bulk
+// import, a threshold change and a snapshot round trip; then O(1) summary vs a full scan
+int run_aggregate_verification() {
+    const char* path = "aggregate_test.snapshot";
+    unsigned int seed = 99;
+    int checks = 0;
+    int failures = 0;
+    inventory_clear();
+    for (int op = 0; op < 20000; op++) {
+        bench_apply_random_op(&seed);
+        if (op == 10000) set_reorder_threshold(40);
+        failures += !inventory_verify_aggregates();
+        checks++;
+    }
+    size_t len;
+    char* csv = bench_build_csv(5000, &len);
+    if (!csv) return 1;
+    import_inventory_csv(csv, len);
+    failures += !inventory_verify_aggregates();
+    save_inventory_snapshot(path);
+    long long units = aggregate_units, cents = aggregate_value_cents;
+    int low = low_stock_count;
+    load_inventory_snapshot(path);
+    failures += !inventory_verify_aggregates() || units != aggregate_units || cents != aggregate_value_cents ||
+                low != low_stock_count;
+    checks += 2;
+    remove(path);
+    free(csv);
+    printf("Aggregate verification: %d/%d checks passed.\n", checks - failures, checks);
+
+    const int n = 1000000;
+    inventory_clear();
+    bench_fill_inventory(n);
+    double start = now_ms();
+    volatile long long sink = 0;
+    for (int i = 0; i < 1000; i++) sink += aggregate_value_cents + aggregate_units + low_stock_count;
+    double running_ms = (now_ms() - start) / 1000;
+    start = now_ms();
+    long long units_scan = 0;
+    long long cents_scan = 0;
+    int low_scan = 0;
+    for (Node* node = head; node; node = node->next) {
+        units_scan += node_quantity(node);
+        cents_scan += product_value_cents(node_quantity(node), node_price(node));
+        low_scan += node_quantity(node) < reorder_threshold;
+    }
+    double scan_ms = now_ms() - start;
+    int summary_match = units_scan == aggregate_units && cents_scan == aggregate_value_cents && low_scan == low_stock_count;
+    failures += !summary_match;
+    printf("Summary at %d products: running %.6f ms, list walk %.1f ms (%s)\n", n, running_ms, scan_ms,
+           summary_match ? "match" : "MISMATCH");
+    inventory_clear();
+    return failures != 0;
+}
+
+// Bytes per product for 1M catalog-like items: the record layout before this store (a full
+// Product inside every Node, names copied into the columns) against compact rows today
+int run_compact_benchmark() {
+    const int n = 1000000;
+    static const char* categories[] = {"Bolt", "Cable", "Panel", "Bracket", "Sensor", "Valve", "Hinge", "Filter"};
+    static const char* finishes[] = {"steel", "brass", "matte black", "white", "anodized", "galvanized"};
+    Product p;
+    inventory_clear();
+    double start = now_ms();
+    for (int i = 0; i < n; i++) {
+        memset(&p, 0, sizeof(p));
+        snprintf(p.name, sizeof(p.name), "%s-%s-%d", categories[i % 8], i % 3 ? "STD" : "PRO", i);
+        p.quantity = i % 250;
+        p.price = (float)(100 + i % 20000) / 100.0f;
+        p.hasDimensions = i % 2 == 0;
+        if (p.hasDimensions) {
+            p.details.dimensions.length = 1 + i % 60;
+            p.details.dimensions.width = 1 + i % 40;
+            p.details.dimensions.height = 1 + i % 25;
+        } else if (i % 10 == 1) { // Some one-off text
+            snprintf(p.details.description, sizeof(p.details.description), "Custom order %d, ships separately", i);
+        } else { // Mostly catalog copy shared across many items
+            snprintf(p.details.description, sizeof(p.details.description), "%s %s, pack of %d",
+                     categories[i % 8], finishes[i % 6], 1 + i / 7 % 50);
+        }
+        inventory_insert(&p);
+    }
+    double build_ms = now_ms() - start;
+
+    // The previous layout: Product embedded in every Node, plus a name copy per column row
+    typedef struct {
+        Product product;
+        Node* next;
+        Node* prev;
+        Node* same_name_next;
+        int column_row;
+        int low_stock_slot;
+    } LegacyNode;
+    const size_t legacy_column_bytes = 5 * sizeof(int) + sizeof(unsigned int) + sizeof(Node*);
+    size_t name_bytes = 0;
+    for (int row = 0; row < columns.count; row++) {
+        name_bytes += strlen(columns.strings + columns.name_offset[row]) + 1;
+    }
+    double legacy_fixed = (double)(sizeof(LegacyNode) + legacy_column_bytes);
+    double legacy_total = legacy_fixed + (double)name_bytes / n;
+    double compact_fixed = (double)(sizeof(Node) + COLUMN_ROW_BYTES);
+    size_t intern_bytes = (size_t)intern_count * sizeof(InternEntry) + (size_t)intern_slot_capacity * sizeof(unsigned int);
+    double compact_total = compact_fixed + (double)(columns.strings_used + intern_bytes) / n;
+
+    printf("%d products built in %.1f ms, %u distinct descriptions\n", n, build_ms, intern_count);
+    printf("%-30s %10s %10s\n", "Layout", "Fixed B", "Total B");
+    printf("%-30s %10.1f %10.1f\n", "Product in Node + name column", legacy_fixed, legacy_total);
+    printf("%-30s %10.1f %10.1f\n", "Compact rows + string arena", compact_fixed, compact_total);
+    printf("Node %zu -> %zu bytes; %.1fx smaller per product (excluding name index and skip lists)\n",
+           sizeof(LegacyNode), sizeof(Node), legacy_total / compact_total);
+    inventory_clear();
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "--bench-compact") == 0) {
+        return run_compact_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--verify-aggregates") == 0) {
+        return run_aggregate_verification();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-threads") == 0) {
+        return run_thread_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-render") == 0) {
+        return run_render_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-suggest") == 0) {
+        return run_suggest_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-range") == 0) {
+        return run_range_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--journal-crash-test") == 0) {
+        return run_journal_crash_test();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-snapshot") == 0) {
+        return run_snapshot_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-import") == 0) {
+        return run_import_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return run_lookup_benchmark();
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-columns") == 0) {
+        return run_column_benchmark();
+    }
+
+    init_inventory(); // Start with the menu
+    if (argc > 2 && strcmp(argv[1], "--import") == 0) {
+        import_inventory_file(argv[2]);
+        print_main_menu();
+    } else if (argc > 3 && strcmp(argv[1], "--journal") == 0) {
+        // Durable session: recover from snapshot + journal, then keep logging to the journal
+        int replayed = recover_inventory(argv[2], argv[3]);
+        if (replayed >= 0) {
+            printf("Recovered %zu product(s), replayed %d journal record(s).\n", node_pool_live, replayed);
+            open_inventory_journal(argv[3], 0, 0);
+        }
+        print_main_menu();
+    } else if (argc > 2 && strcmp(argv[1], "--load") == 0) {
+        int loaded = load_inventory_snapshot(argv[2]);
+        if (loaded >= 0) {
+            printf("Loaded %d product(s) from snapshot.\n", loaded);
+        }
+        print_main_menu();
+    }
+    if (argc > 1 && strcmp(argv[1], "--verify") == 0) {
+        set_inventory_verify_mode(1); // Check the running aggregates after every mutating input
+    }
+
+    char buffer[100];
+    while (session->active) {
+        // The prompt is already printed by init_inventory or reset_to_main_menu or step handlers
+        if (fgets(buffer, sizeof(buffer), stdin) != NULL) {
+            buffer[strcspn(buffer, "\n")] = 0; // Remove newline
+            if (strlen(buffer) == 0 && session->operation != OP_MAIN_MENU) {
                  printf("Empty input during operation, please provide value or cancel (not implemented yet).\n");
                  // For simplicity, we'll just re-prompt the last thing.
                  // A real CLI might need a cancel option here.
                  // Re-printing the last prompt is tricky without storing it.
                  // Let's just process it, it might be an empty string for description.
             }
-             if (strlen(buffer) > 0 || current_operation == OP_MAIN_MENU) { // Process if not empty or if it's a menu choice
+             if (strlen(buffer) > 0 || session->operation == OP_MAIN_MENU) { // Process if not empty or if it's a menu choice
                 process_inventory_input(buffer);
-            } else if (current_operation != OP_MAIN_MENU) {
+            } else if (session->operation != OP_MAIN_MENU) {
                 // If in an operation and input is empty, re-issue the last prompt.
-                // This is a bit simplified. The actual prompt depends on current_operation and current_step.
+                // This is a bit simplified. The actual prompt depends on session->operation and session->step.
                 // For now, let's just say:
                 printf("Please provide input for the current step.\n");
                 fflush(stdout);
@@ -408,7 +3913,12 @@ int main() {
             break; // EOF
         }
     }
+    shutdown_inventory(); // Already done if the session exited; still needed after EOF
     printf("Local test finished.\n");
+    if (aggregate_verify_mode) {
+        printf("Aggregate verification: %d failure(s).\n", aggregate_verify_failures);
+        return aggregate_verify_failures != 0;
+    }
     return 0;
 }
 #endif
\ No newline at end of file
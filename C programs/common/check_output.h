@@ -0,0 +1,47 @@
+// Description: Output helpers for the native --bench-* and --verify-* modes of the inventory and
+// grade programs. Not used by the Emscripten builds.
+//
+// Each program is still a single translation unit: include this once, from the .c file, in
+// its native-only section.
+
+#ifndef CHECK_OUTPUT_H
+#define CHECK_OUTPUT_H
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+static int quiet_saved_stdout = -1; // Real stdout while quiet_stdout_begin is in effect
+
+// Sends stdout to /dev/null until quiet_stdout_end, so the per-item confirmations of a bulk
+// load stay out of a check's report. Begin/end pairs may repeat but must not nest.
+static inline void quiet_stdout_begin() {
+    fflush(stdout);
+    int devnull = open("/dev/null", O_WRONLY);
+    if (devnull < 0) {
+        return;
+    }
+    quiet_saved_stdout = dup(STDOUT_FILENO);
+    if (quiet_saved_stdout >= 0) {
+        dup2(devnull, STDOUT_FILENO);
+    }
+    close(devnull);
+}
+
+static inline void quiet_stdout_end() {
+    fflush(stdout);
+    if (quiet_saved_stdout >= 0) {
+        dup2(quiet_saved_stdout, STDOUT_FILENO);
+        close(quiet_saved_stdout);
+        quiet_saved_stdout = -1;
+    }
+}
+
+// Prints the closing "Results ok/FAILED" line of a check and returns its exit status
+static inline int report_results(long long problems) {
+    printf("Results %s (%lld problems)\n", problems == 0 ? "ok" : "FAILED", problems);
+    fflush(stdout);
+    return problems != 0;
+}
+
+#endif // CHECK_OUTPUT_H
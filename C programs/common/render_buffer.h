@@ -0,0 +1,97 @@
+// Description: Reusable text buffer for table output, shared by the inventory and grade programs.
+// Rows are formatted into one growing buffer instead of a printf per field, then written out in
+// large chunks or handed back to JavaScript as one string.
+//
+// Each program is still a single translation unit: include this once, from the .c file that
+// renders. Define RENDER_BUFFER_STORAGE first (e.g. as _Thread_local) to give every thread its
+// own buffer.
+
+#ifndef RENDER_BUFFER_H
+#define RENDER_BUFFER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef RENDER_BUFFER_STORAGE
+#define RENDER_BUFFER_STORAGE
+#endif
+
+#define RENDER_CHUNK_BYTES 65536
+
+static RENDER_BUFFER_STORAGE char* render_buffer = NULL;
+static RENDER_BUFFER_STORAGE size_t render_used = 0;
+static RENDER_BUFFER_STORAGE size_t render_capacity = 0;
+
+// Makes room for `extra` more bytes plus a terminating NUL. Returns 0 if the buffer cannot grow.
+static inline int render_reserve(size_t extra) {
+    if (render_used + extra + 1 <= render_capacity) {
+        return 1;
+    }
+    size_t capacity = render_capacity ? render_capacity : RENDER_CHUNK_BYTES;
+    while (capacity < render_used + extra + 1) capacity *= 2;
+    char* buffer = (char*)realloc(render_buffer, capacity);
+    if (!buffer) {
+        return 0;
+    }
+    render_buffer = buffer;
+    render_capacity = capacity;
+    return 1;
+}
+
+// Appends `len` bytes, left-justified and space-padded to `width` like "%-*s"
+static inline void render_bytes(const char* text, size_t len, int width) {
+    size_t pad = (int)len < width ? (size_t)width - len : 0;
+    if (!render_reserve(len + pad)) {
+        return;
+    }
+    memcpy(render_buffer + render_used, text, len);
+    memset(render_buffer + render_used + len, ' ', pad);
+    render_used += len + pad;
+}
+
+static inline void render_text(const char* text, int width) {
+    render_bytes(text, strlen(text), width);
+}
+
+// Writes the decimal digits of `value` to `out` (not NUL-terminated) and returns how many
+static inline int format_uint(char* out, unsigned long long value) {
+    char digits[20];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+    for (int i = 0; i < n; i++) out[i] = digits[n - 1 - i];
+    return n;
+}
+
+// "%-*d" without going through printf
+static inline void render_int(long long value, int width) {
+    char text[24];
+    int n = 0;
+    unsigned long long magnitude = (unsigned long long)value;
+    if (value < 0) {
+        text[n++] = '-';
+        magnitude = 0ULL - magnitude;
+    }
+    n += format_uint(text + n, magnitude);
+    render_bytes(text, (size_t)n, width);
+}
+
+// Writes whatever has been rendered to stdout and empties the buffer
+static inline void render_flush() {
+    if (render_used > 0) {
+        fwrite(render_buffer, 1, render_used, stdout);
+        render_used = 0;
+    }
+}
+
+// Frees this thread's buffer; threads that rendered call it before exiting
+static inline void render_release() {
+    free(render_buffer);
+    render_buffer = NULL;
+    render_used = render_capacity = 0;
+}
+
+#endif // RENDER_BUFFER_H
@@ -0,0 +1,103 @@
+#!/bin/sh
+# Builds every program natively and runs its self-checks. Exits non-zero if any build or
+# check fails. The --bench-* and --verify-* modes listed here end with a non-zero status when
+# their results disagree; sizes are reduced where a mode takes one, so the whole run stays
+# under a minute.
+#
+# Usage: sh "C programs/run_checks.sh"   (CC and CFLAGS are honoured)
+
+src=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+CC=${CC:-cc}
+CFLAGS=${CFLAGS:--O2 -Wall -Wextra}
+failed=0
+passed=0
+
+build() { # name, source
+    if ! $CC $CFLAGS -pthread -o "$work/$1" "$src/$2" -lm; then
+        echo "FAIL build $1"
+        failed=$((failed + 1))
+    fi
+}
+
+# Runs a program from the scratch directory with stdin from $input; passes on exit status 0
+check() { # label, program, args...
+    label=$1
+    shift
+    program=$1
+    shift
+    if (cd "$work" && printf '%b' "$input" | "./$program" "$@" > "$work/$label.log" 2>&1); then
+        echo "ok   $label"
+        passed=$((passed + 1))
+    else
+        echo "FAIL $label (output in the log below)"
+        cat "$work/$label.log"
+        failed=$((failed + 1))
+        return 1
+    fi
+}
+
+# Like check, but also requires `pattern` in the output
+check_output() { # label, pattern, program, args...
+    label=$1
+    pattern=$2
+    shift 2
+    if check "$label" "$@" && ! grep -q -- "$pattern" "$work/$label.log"; then
+        echo "FAIL $label: expected \"$pattern\""
+        passed=$((passed - 1))
+        failed=$((failed + 1))
+    fi
+}
+
+build jukebox "Homework 1/acosta-pliego_steven_jukebox.c"
+build minigame "Homework 2/acosta-pliego_steven_minigame.c"
+build inventory "Homework 3/acosta-pliego_steven_inventory.c"
+build grades "Lab 13/acosta-pliego_steven_dynamic_grade_management.c"
+cp "$src/Homework 1/"song*.txt "$work/"
+
+input=''
+check inventory-aggregates inventory --verify-aggregates
+check inventory-journal-crash inventory --journal-crash-test
+check inventory-lookups inventory --bench
+check inventory-snapshot inventory --bench-snapshot
+check inventory-threads inventory --bench-threads
+
+# Interactive session under --verify: add, update, delete, then exit and end the program
+input='1\nbolt\n40\n0.25\n0\nsteel\n1\nframe\n2\n19.99\n1\n30\n20\n10\n3\nbolt\n5\n4\nframe\n24.50\n5\nbolt\n13\n6\n'
+check_output inventory-session "Aggregate verification: 0 failure(s)" inventory --verify
+
+# A malformed first data row is rejected, not skipped as a header
+printf 'widget,x,2.5,0,bad quantity\ngear,3,1.5,0,ok\n' > "$work/products.csv"
+input='6\n'
+check_output inventory-import "1 row(s) rejected" inventory --import products.csv
+
+input=''
+check grades-stats grades --bench-stats
+check grades-simd grades --bench-simd
+check grades-import grades --bench-import
+check grades-topk grades --bench-topk
+check grades-index grades --bench-index
+check grades-summary grades --bench-summary
+check grades-compact grades --bench-compact
+check grades-external grades --bench-external 200000 4
+check grades-filter grades --bench-filter 200000
+check grades-pipeline grades --bench-pipeline 200000 4
+check grades-parallel grades --bench-parallel 1000000
+
+input='1\n7\nAnn\n90\n80\n70\n60\n50\n3\n4\n'
+check_output grades-session "Ann" grades
+
+# IDs outside int are rejected, not wrapped; INT_MAX and INT_MIN themselves are kept
+printf '5,Ann,90,80,70,60,50\n4294967297,Bob,1,2,3,4,5\n2147483648,Cy,1,2,3,4,5\n-2147483649,Di,1,2,3,4,5\n2147483647,Ed,1,2,3,4,5\n-2147483648,Flo,1,2,3,4,5\n' > "$work/roster.csv"
+input='4\n'
+check_output grades-import-range "Imported 3 student(s), 3 row(s) rejected" grades --import roster.csv
+
+input='1\n9\n0\n'
+check_output jukebox-session "Local Jukebox test finished." jukebox
+
+input='abc\n12\n000\nq\n'
+check_output minigame-session "Invalid input" minigame
+
+echo "$passed passed, $failed failed"
+[ "$failed" -eq 0 ]
@@ -22,6 +22,11 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
   const [output, setOutput] = useState<string[]>([]);
   const [isRunning, setIsRunning] = useState(false);
   const [inputValue, setInputValue] = useState('');
+  const [isScriptMode, setIsScriptMode] = useState(false);
+  const [scriptValue, setScriptValue] = useState('');
+  const [suggestions, setSuggestions] = useState<string[]>([]);
+  const [pageOffset, setPageOffset] = useState(0);
+  const [pageText, setPageText] = useState<string | null>(null);
   const outputContainerRef = useRef<HTMLPreElement>(null);
   // activeTab, originalCodeContent, isLoadingCode states are removed
 
@@ -56,6 +61,66 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
     return processInputFunctionNameOverride || `process_${programId}_input`;
   }
 
+  const getBatchFunctionName = () => {
+    return `process_${programId}_batch`;
+  }
+
+  const getSuggestFunctionName = () => {
+    return `suggest_${programId}_input`;
+  }
+
+  // Asks the program for completions of the partial input, if it exports a suggest function.
+  // The C side returns an empty string whenever the current step doesn't take a name.
+  const updateSuggestions = (partial: string) => {
+    const emModule = moduleRef.current;
+    const suggestFnName = getSuggestFunctionName();
+    if (!emModule || typeof emModule['_' + suggestFnName] !== 'function' || !partial.trim()) {
+      setSuggestions([]);
+      return;
+    }
+    try {
+      const result: string = emModule.ccall(suggestFnName, 'string', ['string'], [partial]);
+      setSuggestions(result ? result.split('\n').filter(Boolean) : []);
+    } catch (e: any) {
+      console.warn(`[${programId}] Error fetching suggestions:`, e);
+      setSuggestions([]);
+    }
+  };
+
+  const PAGE_SIZE = 50;
+
+  const hasPagedTable = () => {
+    return typeof moduleRef.current?.[`_render_${programId}_page`] === 'function'
+      && typeof moduleRef.current?.[`_${programId}_row_count`] === 'function';
+  }
+
+  // Fetches one window of the program's table instead of printing every row to the output.
+  const showPage = (offset: number) => {
+    const emModule = moduleRef.current;
+    if (!emModule || !hasPagedTable()) return;
+    try {
+      const total: number = emModule.ccall(`${programId}_row_count`, 'number', [], []);
+      const lastPage = Math.max(0, Math.floor((total - 1) / PAGE_SIZE) * PAGE_SIZE);
+      const clamped = Math.min(Math.max(0, offset), lastPage);
+      const text: string = emModule.ccall(`render_${programId}_page`, 'string', ['number', 'number'], [clamped, PAGE_SIZE]);
+      setPageOffset(clamped);
+      setPageText(text);
+    } catch (e: any) {
+      console.error(`[${programId}] Error rendering page:`, e);
+      setOutput(prev => [...prev, `Error rendering page: ${e.message || String(e)}`]);
+    }
+  };
+
+  // public/jukebox.{js,wasm} are still the -sASYNCIFY build, so its calls must go through an
+  // async ccall. Drop this together with -sASYNCIFY in commands.txt when they are rebuilt.
+  const getCcallOptions = () => {
+    const ccallOptions: { async?: boolean } = {};
+    if (programId === "jukebox") {
+        ccallOptions.async = true;
+    }
+    return ccallOptions;
+  }
+
   const handleInitializeProgram = () => {
     const initFnName = getInitFunctionName();
     const actualModuleFunctionName = '_' + initFnName;
@@ -104,16 +169,12 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
 
     try {
       if (typeof moduleRef.current[actualModuleProcessFnName] === 'function') {
-        const ccallOptions: { async?: boolean } = {};
-        if (programId === "jukebox") {
-            ccallOptions.async = true;
-        }
         moduleRef.current.ccall(
             processFnName,
             'void',
             ['string'],
             [inputValue],
-            ccallOptions
+            getCcallOptions()
         );
       } else {
         const msg = `[${programId}] Input handling function '${actualModuleProcessFnName}' not found on Module. Check export settings.`;
@@ -125,6 +186,57 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
       setOutput(prev => [...prev, `Error sending input: ${e.message || String(e)}`]);
     }
     setInputValue('');
+    setSuggestions([]);
+  };
+
+  // Sends every line of the script in one call to process_<id>_batch. The script is copied
+  // into wasm memory once instead of going through ccall's per-call string marshalling.
+  const handleRunScript = async () => {
+    const emModule = moduleRef.current;
+    const processFnName = getProcessInputFunctionName();
+    const batchFnName = getBatchFunctionName();
+
+    if (!scriptValue.trim()) {
+      setOutput(prev => [...prev, "Please enter at least one command before running the script."]);
+      return;
+    }
+
+    if (!isLoaded || !emModule || typeof emModule.ccall !== 'function') {
+      const msg = `[${programId}] Module not ready to run script. Loaded: ${isLoaded}, Running: ${isRunning}, Module: ${!!emModule}`;
+      console.warn(msg);
+      setOutput(prev => [...prev, msg]);
+      return;
+    }
+
+    const lines = scriptValue.split('\n').map(line => line.replace(/\r$/, '')).filter(line => line.length > 0);
+    setOutput(prev => [...prev, `> [script: ${lines.length} command(s)]`]);
+
+    try {
+      if (typeof emModule['_' + batchFnName] === 'function' && typeof emModule._malloc === 'function' && emModule.HEAPU8) {
+        const bytes = new TextEncoder().encode(scriptValue);
+        const ptr = emModule._malloc(bytes.length + 1);
+        // Read HEAPU8 after malloc: memory growth replaces the view
+        emModule.HEAPU8.set(bytes, ptr);
+        emModule.HEAPU8[ptr + bytes.length] = 0;
+        try {
+          await emModule.ccall(batchFnName, 'void', ['number', 'number'], [ptr, bytes.length], getCcallOptions());
+        } finally {
+          emModule._free(ptr);
+        }
+      } else if (typeof emModule['_' + processFnName] === 'function') {
+        // Builds without the batch export: fall back to one call per line
+        for (const line of lines) {
+          await emModule.ccall(processFnName, 'void', ['string'], [line], getCcallOptions());
+        }
+      } else {
+        const msg = `[${programId}] Neither '_${batchFnName}' nor '_${processFnName}' found on Module. Check export settings.`;
+        console.warn(msg, emModule);
+        setOutput(prev => [...prev, msg]);
+      }
+    } catch (e: any) {
+      console.error(`[${programId}] Error running script:`, e);
+      setOutput(prev => [...prev, `Error running script: ${e.message || String(e)}`]);
+    }
   };
 
   // tabButtonStyle function is removed
@@ -144,11 +256,60 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
       )}
 
       {isLoaded && isRunning && (
+        <div style={{ margin: '1em 0 0 0' }}>
+          <button
+            onClick={() => setIsScriptMode(mode => !mode)}
+            className="cprogram-runner-button"
+          >
+            {isScriptMode ? 'Single Input Mode' : 'Script Mode'}
+          </button>
+          {hasPagedTable() && (
+            <button
+              onClick={() => pageText === null ? showPage(0) : setPageText(null)}
+              className="cprogram-runner-button"
+              style={{ marginLeft: '0.5em' }}
+            >
+              {pageText === null ? 'Table View' : 'Hide Table'}
+            </button>
+          )}
+        </div>
+      )}
+
+      {isLoaded && isRunning && pageText !== null && (
+        <div style={{ margin: '1em 0' }}>
+          <button onClick={() => showPage(pageOffset - PAGE_SIZE)} className="cprogram-runner-button">Prev</button>
+          <button onClick={() => showPage(pageOffset + PAGE_SIZE)} className="cprogram-runner-button" style={{ marginLeft: '0.5em' }}>Next</button>
+          <button onClick={() => showPage(pageOffset)} className="cprogram-runner-button" style={{ marginLeft: '0.5em' }}>Refresh</button>
+          <pre style={{ backgroundColor: 'black', border: '1px solid #333', padding: '0.5em', marginTop: '0.5em', maxHeight: '400px', overflow: 'auto' }}>
+            {pageText}
+          </pre>
+        </div>
+      )}
+
+      {isLoaded && isRunning && isScriptMode && (
+        <div style={{ margin: '1em 0' }}>
+          <textarea
+            value={scriptValue}
+            onChange={(e) => setScriptValue(e.target.value)}
+            placeholder="Paste commands, one per line"
+            rows={8}
+            style={{ display: 'block', width: '100%', marginBottom: '0.5em', padding: '0.5em', color: 'black', backgroundColor: 'white', border: '1px solid #ccc', borderRadius: '4px', fontFamily: 'monospace' }}
+          />
+          <button
+            onClick={handleRunScript}
+            className="cprogram-runner-button"
+          >
+            Run Script
+          </button>
+        </div>
+      )}
+
+      {isLoaded && isRunning && !isScriptMode && (
         <div style={{ margin: '1em 0' }}>
           <input
             type="text"
             value={inputValue}
-            onChange={(e) => setInputValue(e.target.value)}
+            onChange={(e) => { setInputValue(e.target.value); updateSuggestions(e.target.value); }}
             placeholder="Enter input for the program"
             style={{ marginRight: '0.5em', padding: '0.5em', color: 'black', backgroundColor: 'white', border: '1px solid #ccc', borderRadius: '4px' }}
             onKeyPress={(e) => { if (e.key === 'Enter') handleSendInput(); }}
@@ -160,6 +321,19 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
           >
             Send Input
           </button>
+          {suggestions.length > 0 && (
+            <div style={{ marginTop: '0.5em', display: 'flex', flexWrap: 'wrap', gap: '0.5em' }}>
+              {suggestions.map(name => (
+                <button
+                  key={name}
+                  onClick={() => { setInputValue(name); setSuggestions([]); }}
+                  style={{ padding: '0.2em 0.6em', color: 'black', backgroundColor: '#ddd', border: '1px solid #ccc', borderRadius: '4px', cursor: 'pointer' }}
+                >
+                  {name}
+                </button>
+              ))}
+            </div>
+          )}
         </div>
       )}
 
@@ -171,7 +345,7 @@ const CProgramRunner: React.FC<CProgramRunnerProps> = ({
         {output.join('\n')}
       </pre>
       <p style={{fontSize: '0.8em', color: 'gray'}}>
-        <strong>Note:</strong> Click &quot;Start&quot; first. Then enter your input.
+        <strong>Note:</strong> Click &quot;Start&quot; first. Then enter your input, or use Script Mode to send many lines at once.
       </p>
     </div>
   );
@@ -70,6 +70,24 @@ export const useEmscripten = ({
     setIsLoaded(false);
     moduleRef.current = null;
 
+    // Emscripten calls print once per output line. Collect lines and commit them to React
+    // state once per animation frame, so a batch of thousands of lines is one re-render.
+    let pendingOutput: string[] = [];
+    let flushHandle: number | null = null;
+    const flushOutput = () => {
+      flushHandle = null;
+      if (pendingOutput.length === 0) return;
+      const lines = pendingOutput;
+      pendingOutput = [];
+      setOutput(prev => [...prev, ...lines]);
+    };
+    const queueOutput = (text: string) => {
+      pendingOutput.push(text);
+      if (flushHandle === null) {
+        flushHandle = window.requestAnimationFrame(flushOutput);
+      }
+    };
+
     // --- SCRIPT LOADING ---
     scriptElement = document.createElement('script');
     scriptElement.id = scriptId;
@@ -86,11 +104,11 @@ export const useEmscripten = ({
         
         const moduleConfig = {
           print: (text: string) => {
-            setOutput(prev => [...prev, text]);
+            queueOutput(text);
           },
           printErr: (text: string) => {
             console.error(`[${programId} STDERR]:`, text);
-            setOutput(prev => [...prev, `ERROR: ${text}`]);
+            queueOutput(`ERROR: ${text}`);
           },
           locateFile: (path: string, scriptDirectoryPath: string) => {
             const actualScriptDir = scriptPath.substring(0, scriptPath.lastIndexOf('/') + 1);
@@ -152,6 +170,11 @@ export const useEmscripten = ({
 
     // --- EFFECT CLEANUP FUNCTION ---
     return () => {
+      if (flushHandle !== null) {
+        window.cancelAnimationFrame(flushHandle);
+        flushHandle = null;
+      }
+
       if (currentScriptElementForCleanup && currentScriptElementForCleanup.parentElement) {
         currentScriptElementForCleanup.parentElement.removeChild(currentScriptElementForCleanup);
       }